@@ -0,0 +1,294 @@
+#ifndef ASYNC_LOGGER_HPP
+#define ASYNC_LOGGER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+enum class OverflowPolicy
+{
+    block, // producer waits until the writer makes room
+    drop   // message is discarded (and counted in dropped())
+};
+
+// Asynchronous logger:
+//  - producers format a message in a thread local buffer and copy it into a fixed-size record
+//    of a lock-free MPSC ring buffer (no mutex, no allocation on the hot path)
+//  - a dedicated writer thread moves records into a large batch and writes it with a single write + flush
+//  - the batch is written when it is full, when the queue is empty and flush_interval has passed, or in destructor
+//  - messages longer than max_message_size are truncated
+class AsyncLogger
+{
+    static constexpr size_t cache_line_size = 64;
+    static constexpr size_t record_size = 256;
+    static constexpr size_t batch_size = 64 * 1024;
+    static constexpr int spin_count_ = 64;
+
+    struct alignas(cache_line_size) Slot
+    {
+        std::atomic<size_t> sequence;
+        uint32_t length;
+        char text[record_size - sizeof(std::atomic<size_t>) - sizeof(uint32_t)];
+    };
+
+    static_assert(sizeof(Slot) == record_size);
+
+public:
+    static constexpr size_t max_message_size = sizeof(Slot::text);
+    static constexpr size_t default_capacity = 8192;
+
+    // capacity - number of records in the queue (rounded up to a power of 2)
+    explicit AsyncLogger(const std::string& file_name, OverflowPolicy policy = OverflowPolicy::block,
+        std::chrono::milliseconds flush_interval = std::chrono::milliseconds {100}, size_t capacity = default_capacity)
+        : fout_ {file_name, std::ios::binary}
+        , policy_ {policy}
+        , flush_interval_ {flush_interval}
+        , capacity_ {round_up_to_power_of_2(std::max<size_t>(capacity, 2))}
+        , slots_ {new Slot[capacity_]}
+    {
+        for (size_t i = 0; i < capacity_; ++i)
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+
+        writer_ = std::thread {[this] { run_writer(); }};
+    }
+
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    // writes all pending messages - all producers must be done before the logger is destroyed
+    ~AsyncLogger()
+    {
+        {
+            std::lock_guard<std::mutex> lk {mtx_writer_};
+            done_ = true;
+        }
+        cv_writer_.notify_one();
+        writer_.join();
+    }
+
+    // log("Log#", id, " - Event#", i) - arguments are concatenated into one line
+    template <typename... Args>
+    void log(const Args&... args)
+    {
+        if constexpr (sizeof...(Args) == 1 && (std::is_convertible_v<const Args&, std::string_view> && ...))
+        {
+            push_record(std::string_view {args...});
+        }
+        else
+        {
+            thread_local std::string buffer;
+            buffer.clear();
+            (append(buffer, args), ...);
+            push_record(buffer);
+        }
+    }
+
+    // number of messages discarded with OverflowPolicy::drop
+    size_t dropped() const
+    {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+private:
+    static size_t round_up_to_power_of_2(size_t value)
+    {
+        size_t result = 1;
+        while (result < value)
+            result <<= 1;
+        return result;
+    }
+
+    template <typename T>
+    static void append(std::string& buffer, const T& arg)
+    {
+        if constexpr (std::is_convertible_v<const T&, std::string_view>)
+        {
+            buffer.append(std::string_view {arg});
+        }
+        else if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>)
+        {
+            char digits[24];
+            const auto [end, ec] = std::to_chars(std::begin(digits), std::end(digits), arg);
+            buffer.append(digits, end);
+        }
+        else
+        {
+            std::ostringstream out;
+            out << arg;
+            buffer.append(out.str());
+        }
+    }
+
+    void push_record(std::string_view message)
+    {
+        for (int i = 0; !try_push_record(message); ++i)
+        {
+            if (policy_ == OverflowPolicy::drop)
+            {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            // backpressure - queue is full, make sure the writer is awake and give it time to drain
+            wake_writer();
+            if (i < spin_count_)
+                std::this_thread::yield();
+            else
+                std::this_thread::sleep_for(std::chrono::microseconds {50});
+        }
+    }
+
+    // producers claim slots with CAS on tail_ and fill them in place
+    bool try_push_record(std::string_view message)
+    {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            Slot& slot = slots_[pos & (capacity_ - 1)];
+            const size_t seq = slot.sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+            if (diff == 0)
+            {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    const size_t length = std::min(message.size(), max_message_size);
+                    std::memcpy(slot.text, message.data(), length);
+                    slot.length = static_cast<uint32_t>(length);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+
+                    // a sleeping writer is woken up every half of the queue - long before it overflows
+                    if ((pos & (capacity_ / 2 - 1)) == 0)
+                        wake_writer();
+
+                    return true;
+                }
+            }
+            else if (diff < 0)
+                return false; // full
+            else
+                pos = tail_.load(std::memory_order_relaxed);
+        }
+    }
+
+    // pairs with the fence in run_writer(): either the writer sees the new record
+    // or we see it sleeping and wake it up
+    void wake_writer()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (writer_sleeping_.load(std::memory_order_relaxed))
+        {
+            {
+                std::lock_guard<std::mutex> lk {mtx_writer_};
+                wake_requested_ = true;
+            }
+            cv_writer_.notify_one();
+        }
+    }
+
+    // single consumer - head_ is touched only by the writer thread
+    bool pop_record(std::string& batch)
+    {
+        Slot& slot = slots_[head_ & (capacity_ - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != head_ + 1)
+            return false; // empty
+
+        batch.append(slot.text, slot.length);
+        batch.push_back('\n');
+        slot.sequence.store(head_ + capacity_, std::memory_order_release);
+        ++head_;
+        return true;
+    }
+
+    void write_batch(std::string& batch)
+    {
+        if (!batch.empty())
+        {
+            fout_.write(batch.data(), batch.size());
+            fout_.flush();
+            batch.clear();
+        }
+        last_write_ = std::chrono::steady_clock::now();
+    }
+
+    void run_writer()
+    {
+        std::string batch;
+        batch.reserve(batch_size + record_size);
+        last_write_ = std::chrono::steady_clock::now();
+
+        while (true)
+        {
+            while (pop_record(batch))
+            {
+                if (batch.size() >= batch_size)
+                    write_batch(batch);
+            }
+
+            const auto flush_deadline = last_write_ + flush_interval_;
+            if (!batch.empty() && std::chrono::steady_clock::now() >= flush_deadline)
+                write_batch(batch);
+
+            std::unique_lock<std::mutex> lk {mtx_writer_};
+
+            if (done_)
+            {
+                lk.unlock();
+                while (pop_record(batch)) { }
+                write_batch(batch);
+                return;
+            }
+
+            writer_sleeping_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            const Slot& next = slots_[head_ & (capacity_ - 1)];
+            if (next.sequence.load(std::memory_order_relaxed) != head_ + 1)
+            {
+                const auto wake_up_time = batch.empty()
+                    ? std::chrono::steady_clock::now() + flush_interval_
+                    : flush_deadline;
+                cv_writer_.wait_until(lk, wake_up_time, [this] { return wake_requested_ || done_; });
+            }
+
+            wake_requested_ = false;
+            writer_sleeping_.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    std::ofstream fout_;
+    const OverflowPolicy policy_;
+    const std::chrono::milliseconds flush_interval_;
+    const size_t capacity_;
+    std::unique_ptr<Slot[]> slots_;
+
+    alignas(cache_line_size) std::atomic<size_t> tail_ {0};
+    alignas(cache_line_size) std::atomic<size_t> dropped_ {0};
+    std::atomic<bool> writer_sleeping_ {false};
+
+    // owned by the writer thread
+    alignas(cache_line_size) size_t head_ {0};
+    std::chrono::steady_clock::time_point last_write_;
+
+    std::mutex mtx_writer_;
+    std::condition_variable cv_writer_;
+    bool wake_requested_ {false};
+    bool done_ {false};
+    std::thread writer_;
+};
+
+#endif // ASYNC_LOGGER_HPP
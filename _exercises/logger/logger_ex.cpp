@@ -1,9 +1,14 @@
+#include "async_logger.hpp"
+
 #include <chrono>
+#include <cstdio>
 #include <fstream>
 #include <functional>
 #include <iostream>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 
 using namespace std;
 
@@ -35,25 +40,91 @@ namespace Before
     };
 }
 
-using namespace Before;
+namespace Synchronized
+{
+    // thread-safe version of Before::Logger - every message still costs a flush (syscall)
+    class Logger
+    {
+        ofstream fout_;
+        mutex mtx_;
+
+    public:
+        Logger(const string& file_name)
+        {
+            fout_.open(file_name);
+        }
+
+        Logger(const Logger&) = delete;
+        Logger& operator=(const Logger&) = delete;
+
+        void log(const string& message)
+        {
+            lock_guard<mutex> lk {mtx_};
+            fout_ << message << endl;
+        }
+    };
+}
+
+const int no_of_events = 100'000;
 
+template <typename Logger>
 void run(Logger& logger, int id)
 {
-    for (int i = 0; i < 1000; ++i)
+    for (int i = 0; i < no_of_events; ++i)
         logger.log("Log#" + to_string(id) + " - Event#" + to_string(i));
 }
 
-int main()
+// messages are formatted in the logger (thread local buffer) - no temporary strings
+void run_async(AsyncLogger& logger, int id)
 {
-    /*
-     * TODO: Write a Logger class which is thread-safe
-     */
+    for (int i = 0; i < no_of_events; ++i)
+        logger.log("Log#", id, " - Event#", i);
+}
+
+// time of logging no_of_threads * no_of_events messages - including destruction (all messages are in the file)
+template <typename Logger, typename Run, typename... Args>
+void benchmark(const string& name, int no_of_threads, Run run, const Args&... args)
+{
+    const auto start = chrono::high_resolution_clock::now();
+    size_t dropped = 0;
+
+    {
+        Logger logger {args...};
+
+        vector<thread> threads;
+        for (int id = 1; id <= no_of_threads; ++id)
+            threads.emplace_back([&, id] { run(logger, id); });
+
+        for (auto& thd : threads)
+            thd.join();
 
-    Logger log("data.log");
+        if constexpr (is_same_v<Logger, AsyncLogger>)
+            dropped = logger.dropped();
+    }
 
-    thread thd1(&run, ref(log), 1);
-    thread thd2(&run, ref(log), 2);
+    const auto end = chrono::high_resolution_clock::now();
+    const auto elapsed_time = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+
+    cout << name << " - threads: " << no_of_threads << "; elapsed = " << elapsed_time << "ms; throughput = "
+         << no_of_threads * no_of_events * 1000LL / max<long long>(elapsed_time, 1) << " msgs/s";
+    if (dropped)
+        cout << "; dropped = " << dropped;
+    cout << endl;
+}
+
+int main()
+{
+    for (int no_of_threads : {1, 2, 4, 8})
+    {
+        benchmark<Synchronized::Logger>("mutex + flush per message", no_of_threads,
+            &run<Synchronized::Logger>, string {"data.log"});
+        benchmark<AsyncLogger>("AsyncLogger (block)", no_of_threads,
+            &run<AsyncLogger>, string {"data.log"}, OverflowPolicy::block);
+        benchmark<AsyncLogger>("AsyncLogger (block, thread local formatting)", no_of_threads,
+            &run_async, string {"data.log"}, OverflowPolicy::block);
+        benchmark<AsyncLogger>("AsyncLogger (drop)", no_of_threads,
+            &run_async, string {"data.log"}, OverflowPolicy::drop);
+    }
 
-    thd1.join();
-    thd2.join();
+    remove("data.log");
 }
@@ -1,3 +1,9 @@
+#include "parallel_algorithms.hpp"
+#include "pi_kernel.hpp"
+#include "thread_pool.hpp"
+#include "work_stealing_thread_pool.hpp"
+
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <cstdlib>
@@ -237,6 +243,81 @@ double calc_pi_multithreading(long N)
 }
 } // namespace fut
 
+namespace pool
+{
+    const long block_size = 100'000;
+
+    // samples are split into fixed blocks, every block gets its own engine seeded with the block index -
+    // chunks of the parallel algorithms are dynamic, so the result depends only on N because the seeds don't depend on them
+    long count_hits_in_block(long block, long N)
+    {
+        std::mt19937_64 rand_engine {static_cast<uint64_t>(block)};
+        std::uniform_real_distribution<double> rand_distr {0, 1.0};
+
+        long hits = 0;
+        const long no_of_samples = std::min(block_size, N - block * block_size);
+        for (long n = 0; n < no_of_samples; ++n)
+        {
+            double x = rand_distr(rand_engine);
+            double y = rand_distr(rand_engine);
+            if (x * x + y * y < 1)
+                hits++;
+        }
+        return hits;
+    }
+
+    long no_of_blocks(long N)
+    {
+        return (N + block_size - 1) / block_size;
+    }
+
+    // the same split/join/accumulate as calc_pi_multithreading*, done by ext::parallel_reduce:
+    // a chunk of blocks is counted by one call, partial hits stay in registers
+    double calc_pi_parallel_reduce(ThreadPool& pool, long N)
+    {
+        const long hits = ext::parallel_reduce(pool, 0L, no_of_blocks(N), 0L, std::plus<>{}, [=](long first_block, long last_block) {
+            long hits = 0;
+            for (long block = first_block; block < last_block; ++block)
+                hits += count_hits_in_block(block, N);
+            return hits;
+        });
+
+        return static_cast<double>(hits) / N * 4;
+    }
+
+    // block by block - the same samples (and the same Pi) as calc_pi_parallel_reduce
+    double calc_pi_parallel_transform_reduce(ThreadPool& pool, long N)
+    {
+        const long hits = ext::parallel_transform_reduce(pool, 0L, no_of_blocks(N), 0L, std::plus<>{}, [=](long block) {
+            return count_hits_in_block(block, N);
+        });
+
+        return static_cast<double>(hits) / N * 4;
+    }
+} // namespace pool
+
+namespace simd
+{
+    const uint32_t seed = 665;
+
+    // counter-based generator - the result depends only on (seed, N), not on the number of threads
+    double calc_pi_single_thread(kernel::InstructionSet instruction_set, long N)
+    {
+        const uint64_t hits = kernel::count_hits(instruction_set, seed, 0, N);
+        return static_cast<double>(hits) / N * 4;
+    }
+
+    template <typename Pool>
+    double calc_pi_parallel_reduce(Pool& pool, long N)
+    {
+        const uint64_t hits = ext::parallel_reduce(pool, 0L, N, uint64_t {0}, std::plus<>{}, [](long first, long last) {
+            return kernel::count_hits(seed, first, last - first);
+        }, 1'000'000L);
+
+        return static_cast<double>(hits) / N * 4;
+    }
+} // namespace simd
+
 int main()
 {
     const long N = 100'000'000;
@@ -317,4 +398,95 @@ int main()
         std::cout << "Pi = " << pi << endl;
         std::cout << "Elapsed = " << elapsed_time << "ms" << endl;
     }  
+
+    // pool of hardware_concurrency() workers + main thread (same number of threads as above)
+    ThreadPool thread_pool(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+
+    //////////////////////////////////////////////////////////////////////////////
+    // thread pool - parallel_reduce
+    {
+        cout << "Pi calculation started (pool parallel_reduce)!" << endl;
+        const auto start = chrono::high_resolution_clock::now();
+
+        double pi = pool::calc_pi_parallel_reduce(thread_pool, N);
+
+        const auto end = chrono::high_resolution_clock::now();
+        const auto elapsed_time = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+
+        cout << "Pi = " << pi << endl;
+        cout << "Elapsed = " << elapsed_time << "ms" << endl;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    // thread pool - parallel_transform_reduce
+    {
+        cout << "Pi calculation started (pool parallel_transform_reduce)!" << endl;
+        const auto start = chrono::high_resolution_clock::now();
+
+        double pi = pool::calc_pi_parallel_transform_reduce(thread_pool, N);
+
+        const auto end = chrono::high_resolution_clock::now();
+        const auto elapsed_time = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+
+        cout << "Pi = " << pi << endl;
+        cout << "Elapsed = " << elapsed_time << "ms" << endl;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    // counter-based RNG - scalar vs SIMD kernel (the same samples, so the same Pi)
+    for (auto instruction_set : {kernel::InstructionSet::scalar, kernel::detect_instruction_set()})
+    {
+        cout << "Pi calculation started (ST Philox " << kernel::to_string(instruction_set) << ")!" << endl;
+        const auto start = chrono::high_resolution_clock::now();
+
+        double pi = simd::calc_pi_single_thread(instruction_set, N);
+
+        const auto end = chrono::high_resolution_clock::now();
+        const auto elapsed_time = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+
+        cout << "Pi = " << pi << endl;
+        cout << "Elapsed = " << elapsed_time << "ms" << endl;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    // thread pool - parallel_reduce with SIMD kernel
+    {
+        cout << "Pi calculation started (pool parallel_reduce Philox " << kernel::to_string(kernel::detect_instruction_set()) << ")!" << endl;
+        const auto start = chrono::high_resolution_clock::now();
+
+        double pi = simd::calc_pi_parallel_reduce(thread_pool, N);
+
+        const auto end = chrono::high_resolution_clock::now();
+        const auto elapsed_time = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+
+        cout << "Pi = " << pi << endl;
+        cout << "Elapsed = " << elapsed_time << "ms" << endl;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    // worker placement - work-stealing pool pinned according to the policy, SIMD kernel, N = 1e9
+    {
+        const long N_placement = 1'000'000'000;
+        double elapsed_none = 0;
+
+        for (auto policy : {ext::AffinityPolicy::none, ext::AffinityPolicy::compact, ext::AffinityPolicy::scatter, ext::AffinityPolicy::per_node})
+        {
+            WorkStealingThreadPool placed_pool(std::max(std::thread::hardware_concurrency(), 1u) - 1, policy);
+
+            cout << "Pi calculation started (work-stealing pool " << ext::to_string(policy) << ", "
+                 << ext::CpuTopology::system().no_of_nodes() << " NUMA node(s))!" << endl;
+            const auto start = chrono::high_resolution_clock::now();
+
+            double pi = simd::calc_pi_parallel_reduce(placed_pool, N_placement);
+
+            const auto end = chrono::high_resolution_clock::now();
+            const auto elapsed_time = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+
+            if (policy == ext::AffinityPolicy::none)
+                elapsed_none = static_cast<double>(elapsed_time);
+
+            cout << "Pi = " << pi << endl;
+            cout << "Elapsed = " << elapsed_time << "ms; speedup vs none = " << elapsed_none / std::max<double>(elapsed_time, 1) << endl;
+        }
+    }
 }
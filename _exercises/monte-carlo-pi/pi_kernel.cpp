@@ -0,0 +1,209 @@
+#include "pi_kernel.hpp"
+
+#include <algorithm>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define PI_KERNEL_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace kernel
+{
+    namespace
+    {
+        constexpr uint32_t philox_m = 0xD256D193;
+        constexpr uint32_t philox_w = 0x9E3779B9;
+        constexpr int philox_rounds = 10;
+        constexpr uint64_t hit_limit = 1ULL << 62;
+
+        bool is_hit(uint32_t seed, uint32_t c0, uint32_t c1)
+        {
+            uint32_t key = seed;
+            for (int r = 0; r < philox_rounds; ++r)
+            {
+                const uint64_t product = static_cast<uint64_t>(philox_m) * c0;
+                c0 = static_cast<uint32_t>(product >> 32) ^ c1 ^ key;
+                c1 = static_cast<uint32_t>(product);
+                key += philox_w;
+            }
+
+            const uint64_t x = c0 >> 1;
+            const uint64_t y = c1 >> 1;
+            return x * x + y * y < hit_limit;
+        }
+
+        // all samples of a block share the upper half of the counter
+        uint64_t count_hits_scalar(uint32_t seed, uint32_t c1, uint32_t c0_first, uint64_t count)
+        {
+            uint64_t hits = 0;
+            for (uint64_t i = 0; i < count; ++i)
+                hits += is_hit(seed, static_cast<uint32_t>(c0_first + i), c1);
+            return hits;
+        }
+
+#ifdef PI_KERNEL_X86_SIMD
+        // 8 samples per instruction
+        __attribute__((target("avx2"))) uint64_t count_hits_avx2(uint32_t seed, uint32_t c1, uint32_t c0_first, uint64_t count)
+        {
+            const __m256i m = _mm256_set1_epi32(static_cast<int>(philox_m));
+            const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+            const __m256i limit = _mm256_set1_epi64x(static_cast<long long>(hit_limit));
+
+            __m256i keys[philox_rounds];
+            for (int r = 0; r < philox_rounds; ++r)
+                keys[r] = _mm256_set1_epi32(static_cast<int>(seed + r * philox_w));
+
+            uint64_t hits = 0;
+            uint64_t i = 0;
+
+            for (; i + 8 <= count; i += 8)
+            {
+                __m256i c0 = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(c0_first + i)), lanes);
+                __m256i c1s = _mm256_set1_epi32(static_cast<int>(c1));
+
+                for (int r = 0; r < philox_rounds; ++r)
+                {
+                    // 32x32 -> 64 bit products of even and odd lanes
+                    const __m256i product_even = _mm256_mul_epu32(c0, m);
+                    const __m256i product_odd = _mm256_mul_epu32(_mm256_srli_epi64(c0, 32), m);
+                    const __m256i hi = _mm256_blend_epi32(_mm256_srli_epi64(product_even, 32), product_odd, 0b10101010);
+                    const __m256i lo = _mm256_blend_epi32(product_even, _mm256_slli_epi64(product_odd, 32), 0b10101010);
+
+                    c0 = _mm256_xor_si256(_mm256_xor_si256(hi, c1s), keys[r]);
+                    c1s = lo;
+                }
+
+                const __m256i x = _mm256_srli_epi32(c0, 1);
+                const __m256i y = _mm256_srli_epi32(c1s, 1);
+
+                const __m256i r2_even = _mm256_add_epi64(_mm256_mul_epu32(x, x), _mm256_mul_epu32(y, y));
+                const __m256i x_odd = _mm256_srli_epi64(x, 32);
+                const __m256i y_odd = _mm256_srli_epi64(y, 32);
+                const __m256i r2_odd = _mm256_add_epi64(_mm256_mul_epu32(x_odd, x_odd), _mm256_mul_epu32(y_odd, y_odd));
+
+                const int mask_even = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(limit, r2_even)));
+                const int mask_odd = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(limit, r2_odd)));
+
+                hits += __builtin_popcount(mask_even) + __builtin_popcount(mask_odd);
+            }
+
+            return hits + count_hits_scalar(seed, c1, static_cast<uint32_t>(c0_first + i), count - i);
+        }
+
+        // 4 samples per instruction
+        __attribute__((target("sse4.2"))) uint64_t count_hits_sse42(uint32_t seed, uint32_t c1, uint32_t c0_first, uint64_t count)
+        {
+            const __m128i m = _mm_set1_epi32(static_cast<int>(philox_m));
+            const __m128i lanes = _mm_setr_epi32(0, 1, 2, 3);
+            const __m128i limit = _mm_set1_epi64x(static_cast<long long>(hit_limit));
+
+            __m128i keys[philox_rounds];
+            for (int r = 0; r < philox_rounds; ++r)
+                keys[r] = _mm_set1_epi32(static_cast<int>(seed + r * philox_w));
+
+            uint64_t hits = 0;
+            uint64_t i = 0;
+
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128i c0 = _mm_add_epi32(_mm_set1_epi32(static_cast<int>(c0_first + i)), lanes);
+                __m128i c1s = _mm_set1_epi32(static_cast<int>(c1));
+
+                for (int r = 0; r < philox_rounds; ++r)
+                {
+                    const __m128i product_even = _mm_mul_epu32(c0, m);
+                    const __m128i product_odd = _mm_mul_epu32(_mm_srli_epi64(c0, 32), m);
+                    const __m128i hi = _mm_blend_epi16(_mm_srli_epi64(product_even, 32), product_odd, 0b11001100);
+                    const __m128i lo = _mm_blend_epi16(product_even, _mm_slli_epi64(product_odd, 32), 0b11001100);
+
+                    c0 = _mm_xor_si128(_mm_xor_si128(hi, c1s), keys[r]);
+                    c1s = lo;
+                }
+
+                const __m128i x = _mm_srli_epi32(c0, 1);
+                const __m128i y = _mm_srli_epi32(c1s, 1);
+
+                const __m128i r2_even = _mm_add_epi64(_mm_mul_epu32(x, x), _mm_mul_epu32(y, y));
+                const __m128i x_odd = _mm_srli_epi64(x, 32);
+                const __m128i y_odd = _mm_srli_epi64(y, 32);
+                const __m128i r2_odd = _mm_add_epi64(_mm_mul_epu32(x_odd, x_odd), _mm_mul_epu32(y_odd, y_odd));
+
+                const int mask_even = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(limit, r2_even)));
+                const int mask_odd = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(limit, r2_odd)));
+
+                hits += __builtin_popcount(mask_even) + __builtin_popcount(mask_odd);
+            }
+
+            return hits + count_hits_scalar(seed, c1, static_cast<uint32_t>(c0_first + i), count - i);
+        }
+#endif
+    }
+
+    InstructionSet detect_instruction_set()
+    {
+#ifdef PI_KERNEL_X86_SIMD
+        static const InstructionSet instruction_set = [] {
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2"))
+                return InstructionSet::avx2;
+            if (__builtin_cpu_supports("sse4.2"))
+                return InstructionSet::sse42;
+            return InstructionSet::scalar;
+        }();
+
+        return instruction_set;
+#else
+        return InstructionSet::scalar;
+#endif
+    }
+
+    const char* to_string(InstructionSet instruction_set)
+    {
+        switch (instruction_set)
+        {
+        case InstructionSet::avx2:
+            return "AVX2";
+        case InstructionSet::sse42:
+            return "SSE4.2";
+        default:
+            return "scalar";
+        }
+    }
+
+    uint64_t count_hits(InstructionSet instruction_set, uint32_t seed, uint64_t first, uint64_t count)
+    {
+        uint64_t hits = 0;
+
+        // split into blocks which do not cross 2^32 boundary - the upper half of the counter is constant in a block
+        while (count > 0)
+        {
+            const uint32_t c0_first = static_cast<uint32_t>(first);
+            const uint32_t c1 = static_cast<uint32_t>(first >> 32);
+            const uint64_t block_size = std::min<uint64_t>(count, (1ULL << 32) - c0_first);
+
+            switch (instruction_set)
+            {
+#ifdef PI_KERNEL_X86_SIMD
+            case InstructionSet::avx2:
+                hits += count_hits_avx2(seed, c1, c0_first, block_size);
+                break;
+            case InstructionSet::sse42:
+                hits += count_hits_sse42(seed, c1, c0_first, block_size);
+                break;
+#endif
+            default:
+                hits += count_hits_scalar(seed, c1, c0_first, block_size);
+            }
+
+            first += block_size;
+            count -= block_size;
+        }
+
+        return hits;
+    }
+
+    uint64_t count_hits(uint32_t seed, uint64_t first, uint64_t count)
+    {
+        return count_hits(detect_instruction_set(), seed, first, count);
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef PI_KERNEL_HPP
+#define PI_KERNEL_HPP
+
+#include <cstdint>
+
+// Monte Carlo pi kernel with a counter-based generator (Philox2x32-10):
+//  - sample i of a stream is a pure function of (seed, i) - no state carried between samples,
+//    so the result does not depend on how [0, N) is split between threads
+//  - x, y are 31-bit integers and the hit test x^2 + y^2 < 2^62 is exact,
+//    so the scalar, SSE4.2 and AVX2 paths return identical counts
+namespace kernel
+{
+    enum class InstructionSet
+    {
+        scalar,
+        sse42,
+        avx2
+    };
+
+    // the best instruction set supported by the running CPU
+    InstructionSet detect_instruction_set();
+
+    const char* to_string(InstructionSet instruction_set);
+
+    // number of samples first, first + 1, ..., first + count - 1 of the stream which fall into the quarter circle
+    uint64_t count_hits(InstructionSet instruction_set, uint32_t seed, uint64_t first, uint64_t count);
+
+    // uses detect_instruction_set()
+    uint64_t count_hits(uint32_t seed, uint64_t first, uint64_t count);
+}
+
+#endif // PI_KERNEL_HPP
@@ -1,6 +1,12 @@
+#include "ledger.hpp"
+
+#include <chrono>
 #include <iostream>
 #include <thread>
 #include <mutex>
+#include <random>
+#include <string>
+#include <vector>
 
 class BankAccount
 {
@@ -104,6 +110,127 @@ void make_transfer(BankAccount& from, BankAccount& to, int no_of_operations)
         from.transfer(to, 1.0);
 }
 
+void make_ledger_withdraws(Ledger& ledger, Ledger::AccountId id, int no_of_operations)
+{
+    for (int i = 0; i < no_of_operations; ++i)
+        ledger.withdraw(id, 100);
+}
+
+void make_ledger_deposits(Ledger& ledger, Ledger::AccountId id, int no_of_operations)
+{
+    for (int i = 0; i < no_of_operations; ++i)
+        ledger.deposit(id, 100);
+}
+
+void make_ledger_transfers(Ledger& ledger, Ledger::AccountId from, Ledger::AccountId to, int no_of_operations)
+{
+    for (int i = 0; i < no_of_operations; ++i)
+        ledger.transfer(from, to, 100);
+}
+
+// the same workload as in main(): withdraws + deposits on account 1, transfers 1 -> 2 and 2 -> 1
+void benchmark_two_accounts(int no_of_operations)
+{
+    {
+        BankAccount ba1(1, 10'000);
+        BankAccount ba2(2, 10'000);
+
+        const auto start = std::chrono::high_resolution_clock::now();
+
+        std::thread thd1(&make_withdraws, std::ref(ba1), no_of_operations);
+        std::thread thd2(&make_deposits, std::ref(ba1), no_of_operations);
+        std::thread thd3(&make_transfer, std::ref(ba1), std::ref(ba2), no_of_operations);
+        std::thread thd4(&make_transfer, std::ref(ba2), std::ref(ba1), no_of_operations);
+
+        thd1.join();
+        thd2.join();
+        thd3.join();
+        thd4.join();
+
+        const auto end = std::chrono::high_resolution_clock::now();
+        const auto elapsed_time = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+        std::cout << "BankAccount (2 accounts) - balances: " << ba1.balance() << ", " << ba2.balance()
+                  << "; elapsed = " << elapsed_time << "ms; transfers/s = "
+                  << 2LL * no_of_operations * 1000 / std::max<long long>(elapsed_time, 1) << std::endl;
+    }
+
+    {
+        Ledger ledger(2, 1'000'000);
+
+        const auto start = std::chrono::high_resolution_clock::now();
+
+        std::thread thd1([&] { make_ledger_withdraws(ledger, 0, no_of_operations); });
+        std::thread thd2([&] { make_ledger_deposits(ledger, 0, no_of_operations); });
+        std::thread thd3([&] { make_ledger_transfers(ledger, 0, 1, no_of_operations); });
+        std::thread thd4([&] { make_ledger_transfers(ledger, 1, 0, no_of_operations); });
+
+        thd1.join();
+        thd2.join();
+        thd3.join();
+        thd4.join();
+
+        const auto end = std::chrono::high_resolution_clock::now();
+        const auto elapsed_time = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+        std::cout << "Ledger (2 accounts) - balances: " << ledger.balance(0) / 100.0 << ", " << ledger.balance(1) / 100.0
+                  << "; elapsed = " << elapsed_time << "ms; transfers/s = "
+                  << 2LL * no_of_operations * 1000 / std::max<long long>(elapsed_time, 1) << std::endl;
+    }
+}
+
+// random transfers between many accounts - contention is spread over the accounts
+void benchmark_many_accounts(size_t no_of_accounts, int no_of_threads, int no_of_operations)
+{
+    auto run = [&](const std::string& name, auto transfer, auto total) {
+        const auto start = std::chrono::high_resolution_clock::now();
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < no_of_threads; ++t)
+        {
+            threads.emplace_back([&, t] {
+                std::mt19937_64 rnd_gen(t);
+                std::uniform_int_distribution<size_t> rnd_account(0, no_of_accounts - 1);
+                for (int i = 0; i < no_of_operations; ++i)
+                    transfer(rnd_account(rnd_gen), rnd_account(rnd_gen));
+            });
+        }
+
+        for (auto& thd : threads)
+            thd.join();
+
+        const auto end = std::chrono::high_resolution_clock::now();
+        const auto elapsed_time = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+        std::cout << name << " (" << no_of_accounts << " accounts, " << no_of_threads << " threads) - total: " << total()
+                  << "; elapsed = " << elapsed_time << "ms; transfers/s = "
+                  << 1LL * no_of_threads * no_of_operations * 1000 / std::max<long long>(elapsed_time, 1) << std::endl;
+    };
+
+    {
+        std::vector<std::unique_ptr<BankAccount>> accounts;
+        for (size_t i = 0; i < no_of_accounts; ++i)
+            accounts.push_back(std::make_unique<BankAccount>(static_cast<int>(i), 10'000));
+
+        run("BankAccount",
+            [&](size_t from, size_t to) { accounts[from]->transfer(*accounts[to], 1.0); },
+            [&] {
+                double total = 0;
+                for (auto& acc : accounts)
+                    total += acc->balance();
+                return total;
+            });
+    }
+
+    {
+        Ledger ledger(no_of_accounts, 1'000'000);
+
+        run("Ledger",
+            [&](size_t from, size_t to) { ledger.transfer(from, to, 100); },
+            [&] { return ledger.total() / 100.0; });
+    }
+}
+
 int main()
 {
     const int NO_OF_ITERS = 10'000'000;
@@ -128,11 +255,13 @@ int main()
         ba1.transfer(ba2, 1000.0);
     } // SC ends
 
-    std::unique_lock lk{ba2, std::try_to_lock};
-    if (lk.owns_lock())
     {
-        std::cout << "Inside CS" << std::endl;
-    }
+        std::unique_lock lk{ba2, std::try_to_lock};
+        if (lk.owns_lock())
+        {
+            std::cout << "Inside CS" << std::endl;
+        }
+    } // must be released before join() - transfer threads need ba2
 
     thd1.join();
     thd2.join();
@@ -142,4 +271,9 @@ int main()
     std::cout << "After all threads are done: ";
     ba1.print();
     ba2.print();
+
+    benchmark_two_accounts(NO_OF_ITERS);
+
+    for (int no_of_threads : {1, 2, 4, 8})
+        benchmark_many_accounts(1024, no_of_threads, 1'000'000);
 }
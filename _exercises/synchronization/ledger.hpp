@@ -0,0 +1,190 @@
+#ifndef LEDGER_HPP
+#define LEDGER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Ledger of accounts with balances in cents - an alternative to a set of BankAccount objects
+//  - every account lives in its own cache line (no false sharing between accounts)
+//  - every account has a version number (seqlock): odd - a writer is inside, even - stable
+//  - writers take the account by CAS on the version, readers never block writers:
+//    they retry when the version was odd or changed while they were reading
+//  - transfer() takes both accounts optimistically (never waits while holding one of them);
+//    after too many failed attempts it falls back to waiting for them in order of ids - no deadlock
+class Ledger
+{
+public:
+    using AccountId = size_t;
+    using Cents = int64_t;
+
+    explicit Ledger(size_t no_of_accounts, Cents initial_balance = 0)
+        : no_of_accounts_ {no_of_accounts}
+        , accounts_ {new Account[no_of_accounts]}
+    {
+        for (size_t i = 0; i < no_of_accounts_; ++i)
+            accounts_[i].balance.store(initial_balance, std::memory_order_relaxed);
+    }
+
+    Ledger(const Ledger&) = delete;
+    Ledger& operator=(const Ledger&) = delete;
+
+    size_t size() const
+    {
+        return no_of_accounts_;
+    }
+
+    Cents balance(AccountId id) const
+    {
+        return account(id).balance.load(std::memory_order_acquire);
+    }
+
+    void deposit(AccountId id, Cents amount)
+    {
+        Account& acc = account(id);
+
+        lock(acc);
+        acc.balance.store(acc.balance.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        unlock(acc);
+    }
+
+    void withdraw(AccountId id, Cents amount)
+    {
+        deposit(id, -amount);
+    }
+
+    void transfer(AccountId from, AccountId to, Cents amount)
+    {
+        if (from == to)
+        {
+            account(from); // only validates id
+            return;
+        }
+
+        Account& acc_from = account(from);
+        Account& acc_to = account(to);
+
+        // always in the same order - the blocking fallback can't deadlock
+        Account& first = from < to ? acc_from : acc_to;
+        Account& second = from < to ? acc_to : acc_from;
+
+        int attempt = 0;
+        for (; attempt < max_optimistic_attempts; ++attempt)
+        {
+            if (try_lock(first))
+            {
+                if (try_lock(second))
+                    break;
+                unlock(first);
+            }
+            backoff(attempt);
+        }
+
+        if (attempt == max_optimistic_attempts)
+        {
+            lock(first);
+            lock(second);
+        }
+
+        acc_from.balance.store(acc_from.balance.load(std::memory_order_relaxed) - amount, std::memory_order_relaxed);
+        acc_to.balance.store(acc_to.balance.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+
+        unlock(second);
+        unlock(first);
+    }
+
+    // sum of all balances at a single point in time (no transfer is counted twice or half-done)
+    Cents total() const
+    {
+        std::vector<uint64_t> versions(no_of_accounts_);
+
+        for (int attempt = 0; attempt < max_optimistic_attempts; ++attempt)
+        {
+            Cents sum = 0;
+            bool consistent = true;
+
+            for (size_t i = 0; i < no_of_accounts_ && consistent; ++i)
+            {
+                versions[i] = accounts_[i].version.load(std::memory_order_acquire);
+                consistent = (versions[i] & 1) == 0;
+                sum += accounts_[i].balance.load(std::memory_order_relaxed);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            for (size_t i = 0; i < no_of_accounts_ && consistent; ++i)
+                consistent = accounts_[i].version.load(std::memory_order_relaxed) == versions[i];
+
+            if (consistent)
+                return sum;
+
+            backoff(attempt);
+        }
+
+        // writers keep changing the accounts - stop them (in order of ids)
+        Cents sum = 0;
+        for (size_t i = 0; i < no_of_accounts_; ++i)
+            lock(accounts_[i]);
+        for (size_t i = 0; i < no_of_accounts_; ++i)
+            sum += accounts_[i].balance.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < no_of_accounts_; ++i)
+            unlock(accounts_[i]);
+
+        return sum;
+    }
+
+private:
+    static constexpr size_t cache_line_size = 64;
+    static constexpr int max_optimistic_attempts = 64;
+
+    struct alignas(cache_line_size) Account
+    {
+        std::atomic<uint64_t> version {0};
+        std::atomic<Cents> balance {0};
+    };
+
+    Account& account(AccountId id) const
+    {
+        if (id >= no_of_accounts_)
+            throw std::out_of_range("Invalid account id");
+        return accounts_[id];
+    }
+
+    static void backoff(int attempt)
+    {
+        if (attempt > 8)
+            std::this_thread::yield();
+    }
+
+    static bool try_lock(Account& acc)
+    {
+        uint64_t version = acc.version.load(std::memory_order_relaxed);
+        if ((version & 1) || !acc.version.compare_exchange_strong(version, version + 1, std::memory_order_acquire, std::memory_order_relaxed))
+            return false;
+
+        // balance stores must not become visible before the odd version
+        std::atomic_thread_fence(std::memory_order_release);
+        return true;
+    }
+
+    static void lock(Account& acc)
+    {
+        for (int attempt = 0; !try_lock(acc); ++attempt)
+            backoff(attempt);
+    }
+
+    static void unlock(Account& acc)
+    {
+        acc.version.store(acc.version.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    const size_t no_of_accounts_;
+    std::unique_ptr<Account[]> accounts_;
+};
+
+#endif // LEDGER_HPP
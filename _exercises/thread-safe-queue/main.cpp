@@ -1,7 +1,55 @@
+#include "bounded_queue.hpp"
+#include "thread_safe_queue.hpp"
+
+#include <chrono>
 #include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
 
 using namespace std;
 
+// no_of_threads producers and no_of_threads consumers hammer the same queue
+template <typename Queue>
+void benchmark_contention(const string& name, int no_of_threads, int no_of_items)
+{
+    Queue q;
+
+    vector<thread> threads;
+
+    auto start = chrono::high_resolution_clock::now();
+
+    for (int i = 0; i < no_of_threads; ++i)
+    {
+        threads.emplace_back([&q, no_of_items] {
+            for (int i = 0; i < no_of_items; ++i)
+                q.push(i);
+        });
+
+        threads.emplace_back([&q, no_of_items] {
+            int item;
+            for (int i = 0; i < no_of_items; ++i)
+                q.pop(item);
+        });
+    }
+
+    for (auto& thd : threads)
+        thd.join();
+
+    auto end = chrono::high_resolution_clock::now();
+    auto elapsed_time = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+
+    cout << name << " - producers/consumers: " << no_of_threads << "/" << no_of_threads
+         << "; elapsed = " << elapsed_time << "ms" << endl;
+}
+
 int main()
 {
+    const int no_of_items = 1'000'000;
+
+    for (int no_of_threads : {1, 2, 4, 8})
+    {
+        benchmark_contention<ThreadSafeQueue<int>>("ThreadSafeQueue", no_of_threads, no_of_items);
+        benchmark_contention<BoundedQueue<int, 1024>>("BoundedQueue", no_of_threads, no_of_items);
+    }
 }
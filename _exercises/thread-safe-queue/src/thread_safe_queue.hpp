@@ -11,6 +11,7 @@ class ThreadSafeQueue
     std::queue<T> q_;
     mutable std::mutex mtx_q_;
     std::condition_variable cv_q_not_empty_;
+    size_t no_of_waiting_ {0};
 public:
     ThreadSafeQueue() = default;
     ThreadSafeQueue(const ThreadSafeQueue&) = delete;
@@ -32,6 +33,16 @@ public:
         cv_q_not_empty_.notify_one();
     }
 
+    void push(T&& item)
+    {
+        {
+            std::lock_guard<std::mutex> lk{mtx_q_};
+            q_.push(std::move(item));
+        }
+
+        cv_q_not_empty_.notify_one();
+    }
+
     void push(std::initializer_list<T> items)
     {
         {
@@ -43,6 +54,27 @@ public:
         cv_q_not_empty_.notify_all();
     }   
 
+    // pushes range of items under one lock and wakes up only as many consumers as needed
+    template <typename InputIt>
+    void push(InputIt first, InputIt last)
+    {
+        size_t no_of_items = 0;
+        size_t no_of_waiting = 0;
+
+        {
+            std::lock_guard<std::mutex> lk{mtx_q_};
+            for (; first != last; ++first, ++no_of_items)
+                q_.push(*first);
+            no_of_waiting = no_of_waiting_;
+        }
+
+        if (no_of_items >= no_of_waiting)
+            cv_q_not_empty_.notify_all();
+        else
+            for (size_t i = 0; i < no_of_items; ++i)
+                cv_q_not_empty_.notify_one();
+    }
+
     // non-blocking operation - returns false when queue is empty 
     // or its mutex is locked by another thread
     bool try_pop(T& item)
@@ -51,7 +83,7 @@ public:
         
         if (lk.owns_lock() && !q_.empty())
         {
-            item = q_.front();
+            item = std::move(q_.front());
             q_.pop();
             
             return true;
@@ -64,8 +96,13 @@ public:
     void pop(T& item)
     {
         std::unique_lock<std::mutex> lk{mtx_q_};
-        cv_q_not_empty_.wait(lk, [this] { return !q_.empty();});
-        item = q_.front();
+        if (q_.empty())
+        {
+            ++no_of_waiting_;
+            cv_q_not_empty_.wait(lk, [this] { return !q_.empty();});
+            --no_of_waiting_;
+        }
+        item = std::move(q_.front());
         q_.pop();        
     } 
 };
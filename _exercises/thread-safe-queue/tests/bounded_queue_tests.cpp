@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+
+#include "bounded_queue.hpp"
+
+using namespace std;
+
+TEST_CASE("BoundedQueue")
+{
+    BoundedQueue<int, 4> bq;
+
+    SECTION("is empty after creation")
+    {
+        REQUIRE(bq.empty() == true);
+    }
+
+    SECTION("is not empty after push")
+    {
+        bq.push(1);
+
+        REQUIRE(bq.empty() == false);
+    }
+
+    SECTION("pops items in FIFO order")
+    {
+        bq.push(1);
+        bq.push(2);
+
+        int item;
+        auto result = bq.try_pop(item);
+
+        REQUIRE(result);
+        REQUIRE(item == 1);
+    }
+
+    SECTION("try_pop returns false when last item removed")
+    {
+        bq.push(1);
+
+        int item;
+        bq.try_pop(item);
+        auto result = bq.try_pop(item);
+
+        REQUIRE(result == false);
+        REQUIRE(bq.empty() == true);
+    }
+
+    SECTION("try_push returns false when queue is full")
+    {
+        bq.push({1, 2, 3, 4});
+
+        REQUIRE(bq.size() == bq.capacity());
+        REQUIRE(bq.try_push(5) == false);
+    }
+
+    SECTION("client waits when poping from empty")
+    {
+        int item;
+
+        chrono::high_resolution_clock::time_point t1;
+
+        thread thd{[&bq, &item, &t1] {
+            bq.pop(item);
+            t1 = chrono::high_resolution_clock::now();
+        }};
+
+        this_thread::sleep_for(200ms);
+        chrono::high_resolution_clock::time_point t2 = chrono::high_resolution_clock::now();
+        bq.push(1);
+        thd.join();
+        REQUIRE(t1 >= t2);
+        REQUIRE(item == 1);
+    }
+
+    SECTION("client waits when pushing to full")
+    {
+        bq.push({1, 2, 3, 4});
+
+        chrono::high_resolution_clock::time_point t1;
+
+        thread thd{[&bq, &t1] {
+            bq.push(5);
+            t1 = chrono::high_resolution_clock::now();
+        }};
+
+        this_thread::sleep_for(200ms);
+        chrono::high_resolution_clock::time_point t2 = chrono::high_resolution_clock::now();
+        int item;
+        bq.pop(item);
+        thd.join();
+        REQUIRE(t1 >= t2);
+        REQUIRE(item == 1);
+    }
+
+    SECTION("when client push many items all waiting threads are notified")
+    {
+        const int size = 3;
+
+        vector<int> items(size);
+        vector<thread> threads(size);
+
+        for (int i = 0; i < size; ++i)
+        {
+            threads[i] = thread{[&bq, i, &items] { bq.pop(items[i]); }};
+        }
+
+        bq.push({1, 2, 3});
+
+        for (auto& thd : threads)
+            thd.join();
+
+        REQUIRE(none_of(items.begin(), items.end(), [](int x) { return x == 0; }));
+    }
+}
+
+TEST_CASE("BoundedQueue - many producers & many consumers")
+{
+    BoundedQueue<int, 64> bq;
+
+    const int no_of_producers = 4;
+    const int no_of_consumers = 4;
+    const int no_of_items = 10'000;
+
+    vector<long> sums(no_of_consumers);
+    vector<thread> threads;
+
+    for (int p = 0; p < no_of_producers; ++p)
+        threads.emplace_back([&bq] {
+            for (int i = 1; i <= no_of_items; ++i)
+                bq.push(i);
+        });
+
+    for (int c = 0; c < no_of_consumers; ++c)
+        threads.emplace_back([&bq, &sum = sums[c]] {
+            for (int i = 0; i < no_of_items; ++i)
+            {
+                int item;
+                bq.pop(item);
+                sum += item;
+            }
+        });
+
+    for (auto& thd : threads)
+        thd.join();
+
+    const long expected = static_cast<long>(no_of_producers) * no_of_items * (no_of_items + 1) / 2;
+    REQUIRE(accumulate(sums.begin(), sums.end(), 0L) == expected);
+    REQUIRE(bq.empty());
+}
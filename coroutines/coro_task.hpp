@@ -0,0 +1,350 @@
+#ifndef CORO_TASK_HPP
+#define CORO_TASK_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ext::coro
+{
+    template <typename T = void>
+    class Task;
+
+    namespace detail
+    {
+        // resumes the awaiting coroutine (symmetric transfer - no stack growth in long chains)
+        struct FinalAwaiter
+        {
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            template <typename Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> finished) noexcept
+            {
+                if (auto continuation = finished.promise().continuation_)
+                    return continuation;
+                return std::noop_coroutine();
+            }
+
+            void await_resume() const noexcept
+            {
+            }
+        };
+
+        class PromiseBase
+        {
+            friend struct FinalAwaiter;
+
+        public:
+            std::suspend_always initial_suspend() const noexcept
+            {
+                return {};
+            }
+
+            FinalAwaiter final_suspend() const noexcept
+            {
+                return {};
+            }
+
+            void unhandled_exception() noexcept
+            {
+                exception_ = std::current_exception();
+            }
+
+            void set_continuation(std::coroutine_handle<> continuation) noexcept
+            {
+                continuation_ = continuation;
+            }
+
+        protected:
+            void rethrow_if_failed() const
+            {
+                if (exception_)
+                    std::rethrow_exception(exception_);
+            }
+
+        private:
+            std::coroutine_handle<> continuation_;
+            std::exception_ptr exception_;
+        };
+
+        template <typename T>
+        class Promise : public PromiseBase
+        {
+            std::optional<T> value_;
+
+        public:
+            Task<T> get_return_object() noexcept;
+
+            template <typename U>
+            void return_value(U&& value)
+            {
+                value_.emplace(std::forward<U>(value));
+            }
+
+            T result()
+            {
+                rethrow_if_failed();
+                return std::move(*value_);
+            }
+        };
+
+        template <>
+        class Promise<void> : public PromiseBase
+        {
+        public:
+            Task<void> get_return_object() noexcept;
+
+            void return_void() const noexcept
+            {
+            }
+
+            void result() const
+            {
+                rethrow_if_failed();
+            }
+        };
+
+        // eagerly started coroutine which destroys itself when finished
+        struct Detached
+        {
+            struct promise_type
+            {
+                Detached get_return_object() const noexcept
+                {
+                    return {};
+                }
+
+                std::suspend_never initial_suspend() const noexcept
+                {
+                    return {};
+                }
+
+                std::suspend_never final_suspend() const noexcept
+                {
+                    return {};
+                }
+
+                void return_void() const noexcept
+                {
+                }
+
+                void unhandled_exception() const noexcept
+                {
+                    std::terminate();
+                }
+            };
+        };
+    }
+
+    // Lazy coroutine - starts when it is awaited (or passed to sync_wait/when_all)
+    //  - a suspended coroutine is only a heap frame - no thread is blocked
+    //  - result or exception is returned to the awaiting coroutine which is resumed on the thread
+    //    where the task has finished
+    template <typename T>
+    class [[nodiscard]] Task
+    {
+    public:
+        using promise_type = detail::Promise<T>;
+
+        Task() = default;
+
+        explicit Task(std::coroutine_handle<promise_type> handle) noexcept
+            : handle_ {handle}
+        {
+        }
+
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        Task(Task&& other) noexcept
+            : handle_ {std::exchange(other.handle_, nullptr)}
+        {
+        }
+
+        Task& operator=(Task&& other) noexcept
+        {
+            if (this != &other)
+            {
+                if (handle_)
+                    handle_.destroy();
+                handle_ = std::exchange(other.handle_, nullptr);
+            }
+            return *this;
+        }
+
+        ~Task()
+        {
+            if (handle_)
+                handle_.destroy();
+        }
+
+        bool is_ready() const noexcept
+        {
+            return !handle_ || handle_.done();
+        }
+
+        auto operator co_await() noexcept
+        {
+            struct Awaiter : WhenReady
+            {
+                decltype(auto) await_resume()
+                {
+                    return this->handle_.promise().result();
+                }
+            };
+
+            return Awaiter {{handle_}};
+        }
+
+        // waits for completion without fetching the result (used by when_all)
+        auto when_ready() noexcept
+        {
+            return WhenReady {handle_};
+        }
+
+    private:
+        struct WhenReady
+        {
+            std::coroutine_handle<promise_type> handle_;
+
+            bool await_ready() const noexcept
+            {
+                return handle_.done();
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+            {
+                handle_.promise().set_continuation(awaiting);
+                return handle_;
+            }
+
+            void await_resume() const noexcept
+            {
+            }
+        };
+
+        std::coroutine_handle<promise_type> handle_ {};
+    };
+
+    namespace detail
+    {
+        template <typename T>
+        Task<T> Promise<T>::get_return_object() noexcept
+        {
+            return Task<T> {std::coroutine_handle<Promise>::from_promise(*this)};
+        }
+
+        inline Task<void> Promise<void>::get_return_object() noexcept
+        {
+            return Task<void> {std::coroutine_handle<Promise>::from_promise(*this)};
+        }
+
+        class WhenAllCounter
+        {
+            std::atomic<size_t> no_of_pending_;
+            std::coroutine_handle<> continuation_;
+
+        public:
+            explicit WhenAllCounter(size_t no_of_tasks)
+                : no_of_pending_ {no_of_tasks + 1}
+            {
+            }
+
+            // the last finished task resumes the awaiting coroutine
+            void arrive()
+            {
+                if (no_of_pending_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    continuation_.resume();
+            }
+
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            // extra count - the awaiting coroutine is not resumed before it has suspended
+            bool await_suspend(std::coroutine_handle<> awaiting) noexcept
+            {
+                continuation_ = awaiting;
+                return no_of_pending_.fetch_sub(1, std::memory_order_acq_rel) != 1;
+            }
+
+            void await_resume() const noexcept
+            {
+            }
+        };
+
+        template <typename T>
+        Detached when_all_item(Task<T>& task, WhenAllCounter& counter)
+        {
+            co_await task.when_ready();
+            counter.arrive();
+        }
+
+        template <typename T>
+        Detached signal_when_done(Task<T>& task, std::mutex& mtx, std::condition_variable& cv, bool& done)
+        {
+            co_await task.when_ready();
+
+            std::lock_guard<std::mutex> lk {mtx};
+            done = true;
+            cv.notify_one();
+        }
+    }
+
+    // starts all tasks at once and resumes the awaiting coroutine when all of them are finished
+    // (the first exception is rethrown after all tasks are finished)
+    template <typename T>
+    auto when_all(std::vector<Task<T>> tasks) -> Task<std::conditional_t<std::is_void_v<T>, void, std::vector<T>>>
+    {
+        detail::WhenAllCounter counter {tasks.size()};
+
+        for (auto& task : tasks)
+            detail::when_all_item(task, counter);
+
+        co_await counter;
+
+        if constexpr (std::is_void_v<T>)
+        {
+            for (auto& task : tasks)
+                co_await task;
+        }
+        else
+        {
+            std::vector<T> results;
+            results.reserve(tasks.size());
+            for (auto& task : tasks)
+                results.push_back(co_await task);
+            co_return results;
+        }
+    }
+
+    // blocks the calling thread until the task is finished - bridge between threads and coroutines
+    template <typename T>
+    T sync_wait(Task<T> task)
+    {
+        std::mutex mtx;
+        std::condition_variable cv;
+        bool done = false;
+
+        detail::signal_when_done(task, mtx, cv, done);
+
+        {
+            std::unique_lock<std::mutex> lk {mtx};
+            cv.wait(lk, [&done] { return done; });
+        }
+
+        return task.operator co_await().await_resume();
+    }
+}
+
+#endif // CORO_TASK_HPP
@@ -0,0 +1,177 @@
+#include "coro_task.hpp"
+#include "scheduler.hpp"
+#include "thread_pool.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::literals;
+
+// the same flow as calculate_square + save_to_file in futures/main.cpp - waiting does not block a thread
+ext::coro::Task<int> calculate_square(ThreadPool& pool, ext::coro::Timer& timer, int x)
+{
+    co_await ext::coro::schedule_on(pool);
+
+    std::cout << "Starting calculation for " << x << " in " << std::this_thread::get_id() << std::endl;
+
+    std::random_device rd;
+    std::uniform_int_distribution<> distr(100, 500);
+
+    co_await timer.sleep_for(std::chrono::milliseconds(distr(rd)));
+
+    if (x % 3 == 0)
+        throw std::runtime_error("Error#3");
+
+    co_return x * x;
+}
+
+ext::coro::Task<void> save_to_file(ext::coro::Timer& timer, const std::string& filename)
+{
+    std::cout << "Saving to file: " << filename << " in " << std::this_thread::get_id() << std::endl;
+
+    co_await timer.sleep_for(300ms);
+
+    std::cout << "File saved: " << filename << " in " << std::this_thread::get_id() << std::endl;
+}
+
+ext::coro::Task<void> calculate_and_save(ThreadPool& pool, ext::coro::Timer& timer, int x)
+{
+    try
+    {
+        int square = co_await calculate_square(pool, timer, x);
+        co_await save_to_file(timer, "square_" + std::to_string(x) + ".txt");
+        std::cout << x << "*" << x << " = " << square << std::endl;
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << "Calculation for " << x << " failed: " << e.what() << std::endl;
+    }
+}
+
+// number of threads of the process (Linux only - 0 elsewhere)
+size_t no_of_threads()
+{
+    std::ifstream status {"/proc/self/status"};
+    std::string line;
+    while (std::getline(status, line))
+    {
+        if (line.rfind("Threads:", 0) == 0)
+            return std::stoul(line.substr(8));
+    }
+    return 0;
+}
+
+// samples the number of threads while alive (the sampler itself is not counted)
+class PeakThreadCounter
+{
+    std::atomic<bool> stopped_ {false};
+    size_t peak_ {0};
+    std::thread thd_;
+
+public:
+    PeakThreadCounter()
+        : thd_ {[this] {
+            while (!stopped_.load())
+            {
+                peak_ = std::max(peak_, no_of_threads() - 1);
+                std::this_thread::sleep_for(1ms);
+            }
+        }}
+    {
+    }
+
+    size_t stop()
+    {
+        stopped_ = true;
+        thd_.join();
+        return peak_;
+    }
+};
+
+ext::coro::Task<long long> square_flow(ThreadPool& pool, ext::coro::Timer& timer, int x, std::chrono::milliseconds io_delay)
+{
+    co_await ext::coro::schedule_on(pool);
+    long long square = 1LL * x * x;
+    co_await timer.sleep_for(io_delay); // simulated I/O
+    co_return square;
+}
+
+long long square_flow_thread(int x, std::chrono::milliseconds io_delay)
+{
+    long long square = 1LL * x * x;
+    std::this_thread::sleep_for(io_delay); // simulated I/O blocks the thread
+    return square;
+}
+
+// no_of_flows concurrent flows of: compute -> wait for I/O -> return
+// std::async needs a thread per waiting flow - it is run in waves to stay below the thread limit
+void benchmark_flows(int no_of_flows, std::chrono::milliseconds io_delay, int async_wave_size)
+{
+    {
+        ThreadPool pool;
+        ext::coro::Timer timer {pool};
+        PeakThreadCounter thread_counter;
+
+        const auto start = std::chrono::high_resolution_clock::now();
+
+        std::vector<ext::coro::Task<long long>> flows;
+        flows.reserve(no_of_flows);
+        for (int i = 0; i < no_of_flows; ++i)
+            flows.push_back(square_flow(pool, timer, i, io_delay));
+
+        long long sum = 0;
+        for (long long square : ext::coro::sync_wait(ext::coro::when_all(std::move(flows))))
+            sum += square;
+
+        const auto end = std::chrono::high_resolution_clock::now();
+
+        std::cout << "coroutines: " << no_of_flows << " flows - sum = " << sum << "; peak threads = " << thread_counter.stop()
+                  << "; elapsed = " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms" << std::endl;
+    }
+
+    {
+        PeakThreadCounter thread_counter;
+
+        const auto start = std::chrono::high_resolution_clock::now();
+
+        long long sum = 0;
+        for (int wave_start = 0; wave_start < no_of_flows; wave_start += async_wave_size)
+        {
+            std::vector<std::future<long long>> flows;
+            for (int i = wave_start; i < std::min(wave_start + async_wave_size, no_of_flows); ++i)
+                flows.push_back(std::async(std::launch::async, &square_flow_thread, i, io_delay));
+
+            for (auto& f : flows)
+                sum += f.get();
+        }
+
+        const auto end = std::chrono::high_resolution_clock::now();
+
+        std::cout << "std::async (waves of " << async_wave_size << "): " << no_of_flows << " flows - sum = " << sum
+                  << "; peak threads = " << thread_counter.stop()
+                  << "; elapsed = " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms" << std::endl;
+    }
+}
+
+int main()
+{
+    {
+        ThreadPool pool {4};
+        ext::coro::Timer timer {pool};
+
+        std::vector<ext::coro::Task<void>> flows;
+        for (int i = 1; i <= 6; ++i)
+            flows.push_back(calculate_and_save(pool, timer, i));
+
+        ext::coro::sync_wait(ext::coro::when_all(std::move(flows)));
+    }
+
+    benchmark_flows(100'000, 10ms, 1'000);
+}
@@ -0,0 +1,172 @@
+#ifndef SCHEDULER_HPP
+#define SCHEDULER_HPP
+
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ext::coro
+{
+    // co_await schedule_on(pool) - the rest of the coroutine runs on a worker of the pool
+    // (the coroutine is never resumed if the pool is shut down with shutdown_now() before)
+    inline auto schedule_on(ThreadPool& pool)
+    {
+        struct Awaiter
+        {
+            ThreadPool& pool_;
+
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            void await_suspend(std::coroutine_handle<> awaiting)
+            {
+                pool_.submit([awaiting] { awaiting.resume(); });
+            }
+
+            void await_resume() const noexcept
+            {
+            }
+        };
+
+        return Awaiter {pool};
+    }
+
+    // co_await timer.sleep_for(duration) - suspends the coroutine and resumes it on the pool after the timeout
+    //  - a single thread waits for the earliest deadline of all sleeping coroutines
+    //  - timer must outlive the sleeping coroutines - pending ones are not resumed after the destruction
+    class Timer
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        explicit Timer(ThreadPool& pool)
+            : pool_ {pool}
+        {
+            thd_ = std::thread {[this] { run(); }};
+        }
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+        ~Timer()
+        {
+            {
+                std::lock_guard<std::mutex> lk {mtx_};
+                stopped_ = true;
+            }
+            cv_.notify_one();
+            thd_.join();
+        }
+
+        auto sleep_until(Clock::time_point deadline)
+        {
+            struct Awaiter
+            {
+                Timer& timer_;
+                Clock::time_point deadline_;
+
+                bool await_ready() const noexcept
+                {
+                    return false;
+                }
+
+                void await_suspend(std::coroutine_handle<> awaiting)
+                {
+                    timer_.add(deadline_, awaiting);
+                }
+
+                void await_resume() const noexcept
+                {
+                }
+            };
+
+            return Awaiter {*this, deadline};
+        }
+
+        template <typename Rep, typename Period>
+        auto sleep_for(const std::chrono::duration<Rep, Period>& duration)
+        {
+            return sleep_until(Clock::now() + duration);
+        }
+
+    private:
+        struct Entry
+        {
+            Clock::time_point deadline;
+            std::coroutine_handle<> handle;
+
+            bool operator>(const Entry& other) const
+            {
+                return deadline > other.deadline;
+            }
+        };
+
+        void add(Clock::time_point deadline, std::coroutine_handle<> handle)
+        {
+            bool is_earliest = false;
+            {
+                std::lock_guard<std::mutex> lk {mtx_};
+                entries_.push_back(Entry {deadline, handle});
+                std::push_heap(entries_.begin(), entries_.end(), std::greater<> {});
+                is_earliest = entries_.front().handle == handle;
+            }
+
+            if (is_earliest)
+                cv_.notify_one();
+        }
+
+        void run()
+        {
+            std::vector<std::coroutine_handle<>> expired;
+
+            std::unique_lock<std::mutex> lk {mtx_};
+            while (!stopped_)
+            {
+                if (entries_.empty())
+                {
+                    cv_.wait(lk);
+                    continue;
+                }
+
+                const auto now = Clock::now();
+                const auto earliest = entries_.front().deadline; // copy - entries_ may grow while waiting
+                if (earliest > now)
+                {
+                    cv_.wait_until(lk, earliest);
+                    continue;
+                }
+
+                while (!entries_.empty() && entries_.front().deadline <= now)
+                {
+                    std::pop_heap(entries_.begin(), entries_.end(), std::greater<> {});
+                    expired.push_back(entries_.back().handle);
+                    entries_.pop_back();
+                }
+
+                lk.unlock();
+                for (auto handle : expired)
+                    pool_.submit([handle] { handle.resume(); });
+                expired.clear();
+                lk.lock();
+            }
+        }
+
+        ThreadPool& pool_;
+        std::mutex mtx_;
+        std::condition_variable cv_;
+        std::vector<Entry> entries_;
+        bool stopped_ {false};
+        std::thread thd_;
+    };
+}
+
+#endif // SCHEDULER_HPP
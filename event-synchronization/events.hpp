@@ -0,0 +1,194 @@
+#ifndef EVENTS_HPP
+#define EVENTS_HPP
+
+#include "futex.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+namespace ext
+{
+    // Event which stays signaled until reset():
+    //  - wait() on a signaled event is a single acquire load
+    //  - waiters sleep on a futex; set() makes a syscall only if somebody sleeps
+    //  - everything written before set() is visible after wait() returns
+    class ManualResetEvent
+    {
+        enum State : uint32_t
+        {
+            not_set = 0,
+            is_set = 1,
+            not_set_with_waiters = 2
+        };
+
+        std::atomic<uint32_t> state_;
+
+    public:
+        explicit ManualResetEvent(bool initially_set = false)
+            : state_ {initially_set ? is_set : not_set}
+        {
+        }
+
+        ManualResetEvent(const ManualResetEvent&) = delete;
+        ManualResetEvent& operator=(const ManualResetEvent&) = delete;
+
+        void set()
+        {
+            if (state_.exchange(is_set, std::memory_order_release) == not_set_with_waiters)
+                futex_wake_all(state_);
+        }
+
+        // waiters which have not seen the event yet keep waiting for the next set()
+        void reset()
+        {
+            uint32_t expected = is_set;
+            state_.compare_exchange_strong(expected, not_set, std::memory_order_relaxed);
+        }
+
+        bool is_signaled() const
+        {
+            return state_.load(std::memory_order_acquire) == is_set;
+        }
+
+        void wait()
+        {
+            uint32_t state = state_.load(std::memory_order_acquire);
+
+            while (state != is_set)
+            {
+                if (state == not_set_with_waiters
+                    || state_.compare_exchange_weak(state, not_set_with_waiters, std::memory_order_relaxed))
+                {
+                    futex_wait(state_, not_set_with_waiters);
+                }
+
+                state = state_.load(std::memory_order_acquire);
+            }
+        }
+    };
+
+    // One-shot countdown - wait() returns after count_down() has been called expected times
+    class Latch
+    {
+        std::atomic<std::ptrdiff_t> counter_;
+        ManualResetEvent done_;
+
+    public:
+        explicit Latch(std::ptrdiff_t expected)
+            : counter_ {expected}
+            , done_ {expected == 0}
+        {
+            assert(expected >= 0);
+        }
+
+        Latch(const Latch&) = delete;
+        Latch& operator=(const Latch&) = delete;
+
+        void count_down(std::ptrdiff_t n = 1)
+        {
+            const std::ptrdiff_t previous = counter_.fetch_sub(n, std::memory_order_acq_rel);
+            assert(previous >= n);
+
+            if (previous == n)
+                done_.set();
+        }
+
+        bool try_wait() const
+        {
+            return done_.is_signaled();
+        }
+
+        void wait()
+        {
+            done_.wait();
+        }
+
+        void arrive_and_wait(std::ptrdiff_t n = 1)
+        {
+            count_down(n);
+            wait();
+        }
+    };
+
+    // Reusable barrier for a fixed group of threads:
+    //  - the last thread which arrives runs on_completion and starts the next phase
+    //  - futex word = (phase << 1) | has_waiters - completion of a phase without sleepers makes no syscall
+    class Barrier
+    {
+        std::atomic<uint32_t> phase_word_ {0};
+        std::atomic<std::ptrdiff_t> remaining_;
+        std::atomic<std::ptrdiff_t> expected_;
+        std::function<void()> on_completion_;
+
+    public:
+        explicit Barrier(std::ptrdiff_t expected, std::function<void()> on_completion = {})
+            : remaining_ {expected}
+            , expected_ {expected}
+            , on_completion_ {std::move(on_completion)}
+        {
+            assert(expected > 0);
+        }
+
+        Barrier(const Barrier&) = delete;
+        Barrier& operator=(const Barrier&) = delete;
+
+        void arrive_and_wait()
+        {
+            const uint32_t phase = arrive();
+            if (phase != completed)
+                wait(phase);
+        }
+
+        // leaves the group - the current and all next phases expect one thread less
+        void arrive_and_drop()
+        {
+            expected_.fetch_sub(1, std::memory_order_relaxed);
+            arrive();
+        }
+
+    private:
+        static constexpr uint32_t has_waiters = 1;
+        static constexpr uint32_t completed = UINT32_MAX;
+
+        // returns the phase to wait for or completed if this thread has completed it
+        uint32_t arrive()
+        {
+            const uint32_t phase = phase_word_.load(std::memory_order_relaxed) >> 1; // can't change before our arrival
+
+            if (remaining_.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                return phase;
+
+            if (on_completion_)
+                on_completion_();
+
+            remaining_.store(expected_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+            if (phase_word_.exchange((phase + 1) << 1, std::memory_order_release) & has_waiters)
+                futex_wake_all(phase_word_);
+
+            return completed;
+        }
+
+        void wait(uint32_t phase)
+        {
+            uint32_t word = phase_word_.load(std::memory_order_acquire);
+
+            while ((word >> 1) == phase)
+            {
+                if ((word & has_waiters)
+                    || phase_word_.compare_exchange_weak(word, word | has_waiters, std::memory_order_relaxed))
+                {
+                    futex_wait(phase_word_, (phase << 1) | has_waiters);
+                }
+
+                word = phase_word_.load(std::memory_order_acquire);
+            }
+        }
+    };
+}
+
+#endif // EVENTS_HPP
@@ -1,3 +1,5 @@
+#include "events.hpp"
+
 #include <algorithm>
 #include <atomic>
 #include <cassert>
@@ -36,15 +38,16 @@ namespace Atomic
             int x = 32;
 
             /////////////////////
-            is_data_ready_.store(true, std::memory_order_relaxed);
+            is_data_ready_.store(true, std::memory_order_release); // data_ is visible after the acquire load of the flag
         }
 
         void consume(int id)
         {
             int y = 665;
 
-            while (!is_data_ready_.load(std::memory_order_relaxed)) ////// MB
+            while (!is_data_ready_.load(std::memory_order_acquire)) ////// MB - relaxed load would not synchronize with the producer
             {
+                std::this_thread::yield(); // still burns CPU - see Events::Data
             }
 
             int sum = std::accumulate(data_.begin(), data_.end(), 0);
@@ -53,6 +56,38 @@ namespace Atomic
     };
 }
 
+namespace Events
+{
+    class Data
+    {
+        std::vector<int> data_;
+        ext::ManualResetEvent data_ready_;
+
+    public:
+        void produce()
+        {
+            std::cout << "Preparing data..." << std::endl;
+            data_.resize(1000);
+            std::random_device rd;
+            std::mt19937_64 rnd_engine {rd()};
+            std::uniform_int_distribution<int> rnd_distr(0, 100);
+            std::generate(data_.begin(), data_.end(), [&]{ return rnd_distr(rnd_engine); });
+            std::this_thread::sleep_for(2s);
+            std::cout << "Data ready..." << std::endl;
+
+            data_ready_.set();
+        }
+
+        void consume(int id)
+        {
+            data_ready_.wait(); // sleeps on futex - after set() only a single load
+
+            int sum = std::accumulate(data_.begin(), data_.end(), 0);
+            std::cout << "Consumer#" << id << " - sum: " << sum << std::endl;
+        }
+    };
+}
+
 class Data
     {
         std::vector<int> data_;
@@ -96,6 +131,151 @@ class Data
         }
     };
 
+// condition_variable + bool - the reference for ManualResetEvent
+class CvEvent
+{
+    bool is_set_ {false};
+    std::mutex mtx_;
+    std::condition_variable cv_;
+
+public:
+    void set()
+    {
+        {
+            std::lock_guard lk {mtx_};
+            is_set_ = true;
+        }
+        cv_.notify_all();
+    }
+
+    void reset()
+    {
+        std::lock_guard lk {mtx_};
+        is_set_ = false;
+    }
+
+    void wait()
+    {
+        std::unique_lock lk {mtx_};
+        cv_.wait(lk, [this] { return is_set_; });
+    }
+};
+
+// round trip: ping.set() -> pong.set() - twice the wake-up latency when the other thread sleeps
+template <typename Event>
+void benchmark_ping_pong(const std::string& name, int no_of_round_trips)
+{
+    Event ping;
+    Event pong;
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::thread thd_ponger {[&] {
+        for (int i = 0; i < no_of_round_trips; ++i)
+        {
+            ping.wait();
+            ping.reset();
+            pong.set();
+        }
+    }};
+
+    for (int i = 0; i < no_of_round_trips; ++i)
+    {
+        ping.set();
+        pong.wait();
+        pong.reset();
+    }
+
+    thd_ponger.join();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+    std::cout << name << " - ping-pong: elapsed = " << elapsed.count() / 1'000'000 << "ms; "
+              << elapsed.count() / no_of_round_trips << "ns per round trip" << std::endl;
+}
+
+// wait() after the event has fired
+template <typename Event>
+void benchmark_signaled_wait(const std::string& name, int no_of_waits, int no_of_threads)
+{
+    Event event;
+    event.set();
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < no_of_threads; ++t)
+            threads.emplace_back([&] {
+                for (int i = 0; i < no_of_waits; ++i)
+                    event.wait();
+            });
+
+        for (auto& thd : threads)
+            thd.join();
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+
+    std::cout << name << " - wait on signaled event (" << no_of_threads << " threads): elapsed = "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms" << std::endl;
+}
+
+void benchmark_events()
+{
+    std::cout << "\n--------------------------\n";
+    std::cout << "ManualResetEvent vs. condition_variable\n";
+
+    benchmark_ping_pong<CvEvent>("CvEvent", 100'000);
+    benchmark_ping_pong<ext::ManualResetEvent>("ManualResetEvent", 100'000);
+
+    benchmark_signaled_wait<CvEvent>("CvEvent", 10'000'000, 4);
+    benchmark_signaled_wait<ext::ManualResetEvent>("ManualResetEvent", 10'000'000, 4);
+}
+
+void latch_and_barrier_demo()
+{
+    std::cout << "\n--------------------------\n";
+    std::cout << "Latch & Barrier\n";
+
+    const int no_of_workers = 4;
+    const int no_of_phases = 10'000;
+
+    ext::Latch start_gate {1};
+    ext::Latch all_done {no_of_workers};
+
+    std::vector<int> partial_sums(no_of_workers);
+    long total = 0;
+    ext::Barrier barrier {no_of_workers, [&] { total += std::accumulate(partial_sums.begin(), partial_sums.end(), 0); }};
+
+    std::vector<std::thread> workers;
+    for (int id = 0; id < no_of_workers; ++id)
+        workers.emplace_back([&, id] {
+            start_gate.wait();
+
+            for (int phase = 0; phase < no_of_phases; ++phase)
+            {
+                partial_sums[id] = id + 1;
+                barrier.arrive_and_wait(); // on_completion reads partial sums of the finished phase
+            }
+
+            all_done.count_down();
+        });
+
+    auto start = std::chrono::high_resolution_clock::now();
+    start_gate.count_down();
+    all_done.wait();
+    auto end = std::chrono::high_resolution_clock::now();
+
+    for (auto& thd : workers)
+        thd.join();
+
+    std::cout << no_of_phases << " barrier phases: elapsed = "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms"
+              << " (total = " << total << ", expected = " << 10L * no_of_phases << ")" << std::endl;
+}
+
 int main()
 {
     std::cout << "Main thread starts..." << std::endl;
@@ -118,5 +298,23 @@ int main()
         thd_consumer_2.join();
     }
 
+    {
+        Events::Data data;
+
+        std::thread thd_producer {[&data]
+            { data.produce(); }};
+        std::thread thd_consumer_1 {[&data]
+            { data.consume(1); }};
+        std::thread thd_consumer_2 {[&data]
+            { data.consume(2); }};
+
+        thd_producer.join();
+        thd_consumer_1.join();
+        thd_consumer_2.join();
+    }
+
+    benchmark_events();
+    latch_and_barrier_demo();
+
     std::cout << "Main thread ends..." << std::endl;
 }
@@ -0,0 +1,97 @@
+#ifndef ADAPTIVE_MUTEX_HPP
+#define ADAPTIVE_MUTEX_HPP
+
+#include "cpu_relax.hpp"
+#include "futex.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+namespace ext
+{
+    // Spin-then-park mutex:
+    //  - fast path: a single CAS 0 -> 1
+    //  - slow path: test-and-test-and-set with exponential backoff (reads don't bounce the cache line)
+    //  - when the spin budget is exhausted: park on a futex (states by U. Drepper "Futexes Are Tricky":
+    //    0 - unlocked, 1 - locked, 2 - locked and maybe contended - only then unlock() makes a syscall)
+    // The spin budget adapts to recent hold times: it follows an average of spins which were needed to get
+    // the lock (short critical sections -> spinning pays off) and shrinks when spinning fails
+    // (long critical sections or more threads than cores -> park early).
+    class AdaptiveMutex
+    {
+        static constexpr uint32_t unlocked = 0;
+        static constexpr uint32_t locked = 1;
+        static constexpr uint32_t contended = 2;
+
+        static constexpr int min_spin_budget = 16;
+        static constexpr int max_spin_budget = 1024;
+        static constexpr int max_backoff = 64;
+
+        std::atomic<uint32_t> state_ {unlocked};
+        std::atomic<int> average_spins_ {max_spin_budget / 4};
+
+    public:
+        AdaptiveMutex() = default;
+        AdaptiveMutex(const AdaptiveMutex&) = delete;
+        AdaptiveMutex& operator=(const AdaptiveMutex&) = delete;
+
+        bool try_lock()
+        {
+            uint32_t expected = unlocked;
+            return state_.compare_exchange_strong(expected, locked, std::memory_order_acquire, std::memory_order_relaxed);
+        }
+
+        void lock()
+        {
+            if (!try_lock())
+                lock_slow();
+        }
+
+        void unlock()
+        {
+            if (state_.exchange(unlocked, std::memory_order_release) == contended)
+                futex_wake_one(state_);
+        }
+
+    private:
+        int spin_budget() const
+        {
+            return std::clamp(2 * average_spins_.load(std::memory_order_relaxed) + min_spin_budget, min_spin_budget, max_spin_budget);
+        }
+
+        // racy read-modify-write is fine - it is only a heuristic
+        void update_average_spins(int spins)
+        {
+            const int average = average_spins_.load(std::memory_order_relaxed);
+            average_spins_.store(average + (spins - average) / 8, std::memory_order_relaxed);
+        }
+
+        void lock_slow()
+        {
+            const int budget = spin_budget();
+            int backoff = 1;
+
+            for (int spins = 0; spins < budget; spins += backoff, backoff = std::min(2 * backoff, max_backoff))
+            {
+                if (state_.load(std::memory_order_relaxed) == unlocked && try_lock())
+                {
+                    update_average_spins(spins);
+                    return;
+                }
+
+                for (int i = 0; i < backoff; ++i)
+                    cpu_relax();
+            }
+
+            // spinning did not pay off - next time give up sooner
+            update_average_spins(0);
+
+            // we may take the lock in state 2 even without contention - it costs only an unnecessary wake-up
+            while (state_.exchange(contended, std::memory_order_acquire) != unlocked)
+                futex_wait(state_, contended);
+        }
+    };
+}
+
+#endif // ADAPTIVE_MUTEX_HPP
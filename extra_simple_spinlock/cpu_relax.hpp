@@ -0,0 +1,43 @@
+#ifndef CPU_RELAX_HPP
+#define CPU_RELAX_HPP
+
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+namespace ext
+{
+    // hint for the CPU that we are in a spin-wait loop (saves power, frees resources for the sibling hyper-thread)
+    inline void cpu_relax()
+    {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        asm volatile("yield");
+#endif
+    }
+
+    // spins with pause for a while, then yields - a waiter must not starve the lock holder
+    // of CPU time when there are more threads than cores
+    class SpinWait
+    {
+        static constexpr int spin_limit = 64;
+        int count_ {0};
+
+    public:
+        void operator()()
+        {
+            if (count_ < spin_limit)
+            {
+                ++count_;
+                cpu_relax();
+            }
+            else
+                std::this_thread::yield();
+        }
+    };
+}
+
+#endif // CPU_RELAX_HPP
@@ -0,0 +1,83 @@
+#ifndef FUTEX_HPP
+#define FUTEX_HPP
+
+#include <atomic>
+#include <cstdint>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <climits>
+#else
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#endif
+
+// Minimal futex interface:
+//  - futex_wait(word, expected) sleeps only if word still holds expected (checked atomically with going to sleep)
+//  - futex_wake_one/all(word) wake threads sleeping on word
+// Spurious wake-ups are possible - callers must re-check their condition in a loop.
+// Linux uses the futex syscall, other platforms a table of mutexes + condition variables keyed by address.
+namespace ext
+{
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex requires a plain 32-bit word");
+
+#if defined(__linux__)
+    inline void futex_wait(std::atomic<uint32_t>& word, uint32_t expected)
+    {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+    }
+
+    inline void futex_wake_one(std::atomic<uint32_t>& word)
+    {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+    }
+
+    inline void futex_wake_all(std::atomic<uint32_t>& word)
+    {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+    }
+#else
+    namespace detail
+    {
+        struct alignas(64) ParkingSlot
+        {
+            std::mutex mtx;
+            std::condition_variable cv;
+        };
+
+        inline ParkingSlot& parking_slot(const void* address)
+        {
+            static ParkingSlot slots[64];
+            return slots[std::hash<const void*> {}(address) % 64];
+        }
+    }
+
+    inline void futex_wait(std::atomic<uint32_t>& word, uint32_t expected)
+    {
+        auto& slot = detail::parking_slot(&word);
+        std::unique_lock<std::mutex> lk {slot.mtx};
+        if (word.load(std::memory_order_relaxed) == expected)
+            slot.cv.wait(lk);
+    }
+
+    inline void futex_wake_all(std::atomic<uint32_t>& word)
+    {
+        auto& slot = detail::parking_slot(&word);
+        {
+            std::lock_guard<std::mutex> lk {slot.mtx};
+        }
+        slot.cv.notify_all();
+    }
+
+    inline void futex_wake_one(std::atomic<uint32_t>& word)
+    {
+        // the slot may be shared with other words - wake everybody, they re-check their condition
+        futex_wake_all(word);
+    }
+#endif
+}
+
+#endif // FUTEX_HPP
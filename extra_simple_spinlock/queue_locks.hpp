@@ -0,0 +1,168 @@
+#ifndef QUEUE_LOCKS_HPP
+#define QUEUE_LOCKS_HPP
+
+#include "cpu_relax.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Fair (FIFO) spin locks - both satisfy BasicLockable, so they work with lock_guard/unique_lock
+namespace ext
+{
+    constexpr size_t cache_line_size = 64;
+
+    // Ticket lock: lock() takes a ticket and waits until it is served
+    //  - FIFO order - no starvation
+    //  - counters live on separate cache lines, so taking a ticket does not disturb the waiters,
+    //    but all waiters still spin on now_serving_ (every unlock() invalidates it in all their caches)
+    class TicketLock
+    {
+        alignas(cache_line_size) std::atomic<uint32_t> next_ticket_ {0};
+        alignas(cache_line_size) std::atomic<uint32_t> now_serving_ {0};
+
+    public:
+        TicketLock() = default;
+        TicketLock(const TicketLock&) = delete;
+        TicketLock& operator=(const TicketLock&) = delete;
+
+        void lock()
+        {
+            const uint32_t ticket = next_ticket_.fetch_add(1, std::memory_order_relaxed);
+
+            SpinWait spin_wait;
+            while (now_serving_.load(std::memory_order_acquire) != ticket)
+                spin_wait();
+        }
+
+        bool try_lock()
+        {
+            uint32_t ticket = now_serving_.load(std::memory_order_relaxed);
+            return next_ticket_.compare_exchange_strong(ticket, ticket + 1, std::memory_order_acquire, std::memory_order_relaxed);
+        }
+
+        void unlock()
+        {
+            // only the owner writes now_serving_
+            now_serving_.store(now_serving_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+    };
+
+    // MCS lock (Mellor-Crummey & Scott): waiters form a linked queue,
+    // every waiter spins on a flag in its own node (own cache line) and the owner hands the lock
+    // directly to its successor - one cache line transfer per unlock() regardless of the number of waiters
+    //  - nodes come from a thread local pool (lock()/unlock() have no node parameter - BasicLockable)
+    //  - the owner's node is stored in the lock, so unlock() must be called by the thread which called lock()
+    class McsLock
+    {
+        struct alignas(cache_line_size) Node
+        {
+            std::atomic<Node*> next {nullptr};
+            std::atomic<bool> locked {false};
+        };
+
+        // a thread may hold many MCS locks at once - one node per held lock
+        class NodePool
+        {
+            std::vector<std::unique_ptr<Node>> nodes_;
+            std::vector<Node*> free_nodes_;
+
+        public:
+            Node* acquire()
+            {
+                if (free_nodes_.empty())
+                {
+                    nodes_.push_back(std::make_unique<Node>());
+                    return nodes_.back().get();
+                }
+
+                Node* node = free_nodes_.back();
+                free_nodes_.pop_back();
+                return node;
+            }
+
+            void release(Node* node)
+            {
+                free_nodes_.push_back(node);
+            }
+        };
+
+        static NodePool& node_pool()
+        {
+            thread_local NodePool pool;
+            return pool;
+        }
+
+        alignas(cache_line_size) std::atomic<Node*> tail_ {nullptr};
+        Node* owner_ {nullptr}; // written and read only by the owner of the lock
+
+    public:
+        McsLock() = default;
+        McsLock(const McsLock&) = delete;
+        McsLock& operator=(const McsLock&) = delete;
+
+        void lock()
+        {
+            Node* node = node_pool().acquire();
+            node->next.store(nullptr, std::memory_order_relaxed);
+            node->locked.store(true, std::memory_order_relaxed);
+
+            Node* predecessor = tail_.exchange(node, std::memory_order_acq_rel);
+            if (predecessor)
+            {
+                predecessor->next.store(node, std::memory_order_release);
+
+                SpinWait spin_wait;
+                while (node->locked.load(std::memory_order_acquire))
+                    spin_wait();
+            }
+
+            owner_ = node;
+        }
+
+        bool try_lock()
+        {
+            Node* node = node_pool().acquire();
+            node->next.store(nullptr, std::memory_order_relaxed);
+
+            Node* expected = nullptr;
+            if (!tail_.compare_exchange_strong(expected, node, std::memory_order_acq_rel, std::memory_order_relaxed))
+            {
+                node_pool().release(node);
+                return false;
+            }
+
+            owner_ = node;
+            return true;
+        }
+
+        void unlock()
+        {
+            Node* node = owner_;
+            Node* successor = node->next.load(std::memory_order_acquire);
+
+            if (!successor)
+            {
+                // no known successor - try to reset the queue
+                Node* expected = node;
+                if (tail_.compare_exchange_strong(expected, nullptr, std::memory_order_release, std::memory_order_relaxed))
+                {
+                    node_pool().release(node);
+                    return;
+                }
+
+                // a new waiter has swapped tail_ but has not linked itself yet
+                SpinWait spin_wait;
+                while (!(successor = node->next.load(std::memory_order_acquire)))
+                    spin_wait();
+            }
+
+            successor->locked.store(false, std::memory_order_release);
+            node_pool().release(node); // the successor does not touch our node any more
+        }
+    };
+}
+
+#endif // QUEUE_LOCKS_HPP
@@ -1,10 +1,19 @@
+#include "adaptive_mutex.hpp"
+#include "queue_locks.hpp"
+
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <cmath>
 #include <iostream>
 #include <mutex>
+#include <string>
 #include <thread>
 #include <vector>
+#include <numeric>
 
 using namespace std;
+using namespace std::literals;
 
 class SpinLockMutex
 {
@@ -42,23 +51,171 @@ void increase()
     }
 }
 
-int main()
+// work inside/outside of the critical section - simulates hold time and time between acquisitions
+void do_work(int amount)
 {
-    cout << "Race Condition" << endl;
-    //cout << "Is this lock-free? " << counter.is_lock_free() << endl;
+    for (volatile int i = 0; i < amount; ++i)
+        continue;
+}
+
+template <typename Mutex>
+void increase(Mutex& mtx, long& counter, long no_of_iterations, int hold_work)
+{
+    for (long i = 0; i < no_of_iterations; ++i)
+    {
+        {
+            lock_guard<Mutex> l(mtx);
+            ++counter;
+            do_work(hold_work);
+        }
+        do_work(16);
+    }
+}
+
+template <typename Mutex>
+void benchmark(const string& name, int no_of_threads, long no_of_iterations, int hold_work)
+{
+    Mutex mtx;
+    long counter = 0;
+    const long iterations_per_thread = no_of_iterations / no_of_threads;
 
     vector<thread> thds;
 
     auto start = chrono::high_resolution_clock::now();
 
-    for (int i = 0; i < 2; ++i)
-        thds.emplace_back(&increase);
+    for (int i = 0; i < no_of_threads; ++i)
+        thds.emplace_back([&] { increase(mtx, counter, iterations_per_thread, hold_work); });
 
     for (auto& th : thds)
         th.join();
 
     auto end = chrono::high_resolution_clock::now();
-    cout << chrono::duration_cast<chrono::microseconds>(end - start).count() << " us" << endl;
 
-    cout << "Counter = " << counter << endl;
+    if (counter != iterations_per_thread * no_of_threads)
+        cout << "Error: counter = " << counter << endl;
+
+    cout << name << " - threads: " << no_of_threads << "; hold work: " << hold_work << "; elapsed = "
+         << chrono::duration_cast<chrono::milliseconds>(end - start).count() << " ms" << endl;
+}
+
+// latency of lock() and fairness: every thread runs increase() for a fixed time
+//  - latency percentiles of lock() calls (all threads together)
+//  - per-thread number of acquisitions: min/max and Jain's fairness index (1.0 - perfectly fair)
+template <typename Mutex>
+void benchmark_fairness(const string& name, int no_of_threads, chrono::milliseconds duration)
+{
+    const size_t max_samples_per_thread = 200'000;
+
+    Mutex mtx;
+    long counter = 0;
+    atomic<bool> start_flag {false};
+    atomic<bool> stop_flag {false};
+    vector<long> acquisitions(no_of_threads);
+    vector<vector<long>> latencies(no_of_threads);
+
+    vector<thread> thds;
+    for (int id = 0; id < no_of_threads; ++id)
+    {
+        thds.emplace_back([&, id] {
+            vector<long> samples;
+            samples.reserve(max_samples_per_thread);
+            long count = 0;
+
+            while (!start_flag.load())
+                this_thread::yield();
+
+            while (!stop_flag.load(memory_order_relaxed))
+            {
+                const auto before_lock = chrono::steady_clock::now();
+                {
+                    lock_guard<Mutex> l(mtx);
+                    const auto after_lock = chrono::steady_clock::now();
+                    ++counter;
+                    do_work(50);
+
+                    if (samples.size() < max_samples_per_thread)
+                        samples.push_back(chrono::duration_cast<chrono::nanoseconds>(after_lock - before_lock).count());
+                }
+                ++count;
+                do_work(50);
+            }
+
+            acquisitions[id] = count;
+            latencies[id] = move(samples);
+        });
+    }
+
+    start_flag = true;
+    this_thread::sleep_for(duration);
+    stop_flag = true;
+
+    for (auto& th : thds)
+        th.join();
+
+    vector<long> all_latencies;
+    for (auto& samples : latencies)
+        all_latencies.insert(all_latencies.end(), samples.begin(), samples.end());
+    sort(all_latencies.begin(), all_latencies.end());
+
+    auto percentile = [&](double p) {
+        return all_latencies.empty() ? 0 : all_latencies[static_cast<size_t>(p * (all_latencies.size() - 1))];
+    };
+
+    const double sum = accumulate(acquisitions.begin(), acquisitions.end(), 0.0);
+    const double sum_of_squares = inner_product(acquisitions.begin(), acquisitions.end(), acquisitions.begin(), 0.0);
+    const double fairness = sum_of_squares > 0 ? sum * sum / (no_of_threads * sum_of_squares) : 0.0;
+    const auto [min_count, max_count] = minmax_element(acquisitions.begin(), acquisitions.end());
+
+    cout << name << " - threads: " << no_of_threads << "; ops = " << counter
+         << "; lock() p50 = " << percentile(0.5) << "ns; p99 = " << percentile(0.99)
+         << "ns; p99.9 = " << percentile(0.999) << "ns; max = " << (all_latencies.empty() ? 0 : all_latencies.back())
+         << "ns; per thread min/max = " << *min_count << "/" << *max_count << "; fairness = " << fairness << endl;
+}
+
+int main()
+{
+    cout << "Race Condition" << endl;
+    //cout << "Is this lock-free? " << counter.is_lock_free() << endl;
+
+    {
+        vector<thread> thds;
+
+        auto start = chrono::high_resolution_clock::now();
+
+        for (int i = 0; i < 2; ++i)
+            thds.emplace_back([] { increase(); });
+
+        for (auto& th : thds)
+            th.join();
+
+        auto end = chrono::high_resolution_clock::now();
+        cout << chrono::duration_cast<chrono::microseconds>(end - start).count() << " us" << endl;
+
+        cout << "Counter = " << counter << endl;
+    }
+
+    // the same amount of work for every number of threads - the last ones oversubscribe the CPU
+    const long no_of_iterations = 1'000'000;
+    const int hardware_threads = static_cast<int>(max(thread::hardware_concurrency(), 1u));
+
+    for (int hold_work : {0, 200})
+    {
+        for (int no_of_threads : {1, 2, 4, 8, 2 * hardware_threads, 4 * hardware_threads})
+        {
+            benchmark<std::mutex>("std::mutex", no_of_threads, no_of_iterations, hold_work);
+            benchmark<SpinLockMutex>("SpinLockMutex", no_of_threads, no_of_iterations, hold_work);
+            benchmark<ext::AdaptiveMutex>("AdaptiveMutex", no_of_threads, no_of_iterations, hold_work);
+        }
+    }
+
+    for (int no_of_threads : {2, 4, 8, 16, 32, 64})
+    {
+        const auto duration = 200ms;
+
+        benchmark_fairness<std::mutex>("std::mutex", no_of_threads, duration);
+        benchmark_fairness<SpinLockMutex>("SpinLockMutex", no_of_threads, duration);
+        benchmark_fairness<ext::AdaptiveMutex>("AdaptiveMutex", no_of_threads, duration);
+        benchmark_fairness<ext::TicketLock>("TicketLock", no_of_threads, duration);
+        benchmark_fairness<ext::McsLock>("McsLock", no_of_threads, duration);
+    }
 }
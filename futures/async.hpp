@@ -0,0 +1,156 @@
+#ifndef ASYNC_HPP
+#define ASYNC_HPP
+
+#include "task.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ext
+{
+    // Process-wide pool used by ext::async()
+    //  - started lazily: no thread exists before the first call, a new thread is created only when a task
+    //    is queued and no worker is idle (up to max_threads)
+    //  - threads are reused and live until the end of the program
+    //  - tasks which wait for other async tasks may deadlock when all max_threads workers are waiting
+    class AsyncThreadPool
+    {
+    public:
+        static AsyncThreadPool& instance()
+        {
+            static AsyncThreadPool pool;
+            return pool;
+        }
+
+        // takes effect for threads created after the call (running threads are not stopped)
+        static void set_max_threads(size_t max_threads)
+        {
+            max_threads_.store(std::max<size_t>(max_threads, 1));
+        }
+
+        static size_t max_threads()
+        {
+            return max_threads_.load();
+        }
+
+        AsyncThreadPool(const AsyncThreadPool&) = delete;
+        AsyncThreadPool& operator=(const AsyncThreadPool&) = delete;
+
+        // runs all queued tasks before the threads are joined
+        ~AsyncThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> lk {mtx_};
+                done_ = true;
+            }
+            cv_tasks_.notify_all();
+
+            for (auto& thd : threads_)
+                thd.join();
+        }
+
+        template <typename Callable>
+        auto submit(Callable&& callable)
+        {
+            using ResultT = std::invoke_result_t<std::decay_t<Callable>&>;
+
+            std::packaged_task<ResultT()> pt {std::forward<Callable>(callable)};
+            std::future<ResultT> f = pt.get_future();
+
+            push(Task {[pt = std::move(pt)]() mutable { pt(); }});
+
+            return f;
+        }
+
+        size_t no_of_threads() const
+        {
+            std::lock_guard<std::mutex> lk {mtx_};
+            return threads_.size();
+        }
+
+    private:
+        AsyncThreadPool() = default;
+
+        void push(Task task)
+        {
+            {
+                std::lock_guard<std::mutex> lk {mtx_};
+                tasks_.push_back(std::move(task));
+
+                // idle workers are already woken up by previously queued tasks
+                if (tasks_.size() > no_of_idle_ && threads_.size() < max_threads())
+                {
+                    threads_.emplace_back([this] { run(); });
+                    return;
+                }
+            }
+
+            cv_tasks_.notify_one();
+        }
+
+        void run()
+        {
+            while (true)
+            {
+                Task task;
+                {
+                    std::unique_lock<std::mutex> lk {mtx_};
+                    ++no_of_idle_;
+                    cv_tasks_.wait(lk, [this] { return !tasks_.empty() || done_; });
+                    --no_of_idle_;
+
+                    if (tasks_.empty())
+                        return;
+
+                    task = std::move(tasks_.front());
+                    tasks_.pop_front();
+                }
+
+                task();
+            }
+        }
+
+        inline static std::atomic<size_t> max_threads_ {std::max(std::thread::hardware_concurrency(), 1u)};
+
+        mutable std::mutex mtx_;
+        std::condition_variable cv_tasks_;
+        std::deque<Task> tasks_;
+        size_t no_of_idle_ {0};
+        bool done_ {false};
+        std::vector<std::thread> threads_;
+    };
+
+    // Drop-in replacement for std::async:
+    //  - std::launch::deferred - delegated to std::async (lazy evaluation in get()/wait())
+    //  - std::launch::async (and the default policy) - runs on AsyncThreadPool instead of a new thread
+    //  - unlike std::async the destructor of the returned future does not wait for the task
+    template <typename Function, typename... Args>
+    auto async(std::launch policy, Function&& f, Args&&... args)
+    {
+        if (policy == std::launch::deferred)
+            return std::async(std::launch::deferred, std::forward<Function>(f), std::forward<Args>(args)...);
+
+        return AsyncThreadPool::instance().submit(
+            [f = std::decay_t<Function>(std::forward<Function>(f)), args = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+                return std::apply(std::move(f), std::move(args));
+            });
+    }
+
+    template <typename Function, typename... Args, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Function>, std::launch>>>
+    auto async(Function&& f, Args&&... args)
+    {
+        return ext::async(std::launch::async | std::launch::deferred, std::forward<Function>(f), std::forward<Args>(args)...);
+    }
+}
+
+#endif // ASYNC_HPP
@@ -1,3 +1,7 @@
+#include "async.hpp"
+
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <chrono>
 #include <functional>
@@ -149,8 +153,85 @@ private:
     std::promise<int> promise_;
 };
 
+// counts threads which have run at least one task of the current benchmark
+std::atomic<size_t> no_of_threads_used {0};
+std::atomic<int> benchmark_id {0};
+
+void register_thread()
+{
+    thread_local int registered_in = -1;
+    if (std::exchange(registered_in, benchmark_id.load()) != benchmark_id.load())
+        ++no_of_threads_used;
+}
+
+// no_of_calls calls of async(work) issued in bursts of burst_size; reports threads used, call latency
+// (submit -> start of the task) and total time
+template <typename Async>
+void benchmark_async(const std::string& name, Async async, size_t no_of_calls, size_t burst_size, std::chrono::microseconds work)
+{
+    ++benchmark_id;
+    no_of_threads_used = 0;
+    std::vector<long long> latencies;
+    latencies.reserve(no_of_calls);
+
+    const auto start = std::chrono::high_resolution_clock::now();
+
+    for (size_t burst_start = 0; burst_start < no_of_calls; burst_start += burst_size)
+    {
+        std::vector<std::future<long long>> results;
+        for (size_t i = burst_start; i < std::min(burst_start + burst_size, no_of_calls); ++i)
+        {
+            const auto submitted = std::chrono::steady_clock::now();
+            results.push_back(async(std::launch::async, [submitted, work]() -> long long {
+                const auto started = std::chrono::steady_clock::now();
+                register_thread();
+                std::this_thread::sleep_for(work);
+                return std::chrono::duration_cast<std::chrono::microseconds>(started - submitted).count();
+            }));
+        }
+
+        for (auto& f : results)
+            latencies.push_back(f.get());
+    }
+
+    const auto end = std::chrono::high_resolution_clock::now();
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) { return latencies[static_cast<size_t>(p * (latencies.size() - 1))]; };
+
+    std::cout << name << " - " << no_of_calls << " calls (bursts of " << burst_size << "): threads used = " << no_of_threads_used
+              << "; latency p50 = " << percentile(0.5) << "us, p99 = " << percentile(0.99) << "us; elapsed = "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms" << std::endl;
+}
+
+void benchmark_async()
+{
+    auto std_async = [](std::launch policy, auto&& f) { return std::async(policy, std::forward<decltype(f)>(f)); };
+    auto ext_async = [](std::launch policy, auto&& f) { return ext::async(policy, std::forward<decltype(f)>(f)); };
+
+    ext::AsyncThreadPool::set_max_threads(std::max(std::thread::hardware_concurrency(), 8u));
+
+    // short tasks one by one - cost of thread creation
+    benchmark_async("std::async", std_async, 10'000, 1, 0us);
+    benchmark_async("ext::async", ext_async, 10'000, 1, 0us);
+
+    // peak load - std::async creates a thread per call, ext::async queues above max_threads
+    benchmark_async("std::async", std_async, 10'000, 1'000, 100us);
+    benchmark_async("ext::async", ext_async, 10'000, 1'000, 100us);
+
+    std::cout << "ext::AsyncThreadPool - threads = " << ext::AsyncThreadPool::instance().no_of_threads()
+              << " (max = " << ext::AsyncThreadPool::max_threads() << ")" << std::endl;
+
+    auto deferred = ext::async(std::launch::deferred, [] { return std::this_thread::get_id(); });
+    const bool is_run_by_caller = deferred.get() == std::this_thread::get_id();
+    std::cout << "ext::async(std::launch::deferred) - run by the calling thread: " << std::boolalpha << is_run_by_caller << std::endl;
+    assert(is_run_by_caller);
+}
+
 int main()
 {
+    benchmark_async();
+
     Calculator calc;
     auto fs = calc.get_future();
     fs = calc.get_future();
@@ -0,0 +1,144 @@
+#ifndef EPOCH_RECLAMATION_HPP
+#define EPOCH_RECLAMATION_HPP
+
+#include "reclamation_detail.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace ext
+{
+    // Epoch-based reclamation (Fraser 2004):
+    //  - a reader pins the current global epoch for the lifetime of a Guard - every pointer loaded
+    //    while pinned may be dereferenced (protect() is a plain load)
+    //  - the global epoch advances only when all pinned readers have seen it, so an object retired
+    //    in epoch e is unreachable for every reader once the global epoch is e + 2
+    //  - cheaper than hazard pointers for readers, but a reader which stays pinned blocks
+    //    the reclamation of all objects retired after it was pinned
+    //  - the domain must outlive all guards and all structures which retire objects in it;
+    //    objects still retired at the destruction of the domain are freed by its destructor
+    class EpochDomain
+    {
+        struct Record
+        {
+            std::atomic<uint64_t> pinned_epoch {not_pinned};
+            std::atomic<bool> in_use {false};
+            Record* next {nullptr};
+        };
+
+        static constexpr uint64_t not_pinned = 0; // epochs start from 1
+
+    public:
+        // pins the current epoch of the domain
+        class Guard
+        {
+        public:
+            explicit Guard(EpochDomain& domain = EpochDomain::global())
+                : domain_ {domain}
+                , record_ {domain.records_.acquire()}
+            {
+                // seq_cst pin & protect() - if try_advance() misses the pin, the reader sees all unlinks made before the scan
+                record_->pinned_epoch.store(domain_.epoch_.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+            }
+
+            Guard(const Guard&) = delete;
+            Guard& operator=(const Guard&) = delete;
+
+            ~Guard()
+            {
+                record_->pinned_epoch.store(not_pinned, std::memory_order_release);
+                domain_.records_.release(record_);
+            }
+
+            template <typename T>
+            T* protect(const std::atomic<T*>& src)
+            {
+                return src.load(std::memory_order_seq_cst); // a plain load on x86
+            }
+
+            // the guard stays pinned - there is nothing to release per pointer
+            void reset()
+            {
+            }
+
+        private:
+            EpochDomain& domain_;
+            Record* record_;
+        };
+
+        EpochDomain() = default;
+        EpochDomain(const EpochDomain&) = delete;
+        EpochDomain& operator=(const EpochDomain&) = delete;
+
+        static EpochDomain& global()
+        {
+            static EpochDomain domain;
+            return domain;
+        }
+
+        // ptr must be unreachable for threads which do not hold it yet - it is deleted two epochs later
+        template <typename T>
+        void retire(T* ptr)
+        {
+            retire(ptr, &detail::delete_object<T>);
+        }
+
+        void retire(void* ptr, void (*deleter)(void*))
+        {
+            const uint64_t epoch = epoch_.load(std::memory_order_seq_cst); // after ptr has been unlinked
+
+            if (retired_.push(new detail::RetiredNode {ptr, deleter, epoch, nullptr}) >= next_reclaim_.load(std::memory_order_relaxed))
+                reclaim();
+        }
+
+        // tries to advance the epoch and frees the objects retired at least two epochs ago - returns their number
+        size_t reclaim()
+        {
+            try_advance();
+
+            const uint64_t epoch = epoch_.load(std::memory_order_seq_cst);
+            const size_t no_of_reclaimed = retired_.reclaim_if([epoch](const detail::RetiredNode& node) { return node.epoch + 2 <= epoch; });
+
+            // a pinned reader may block the epoch for long (e.g. preempted) - scans of the growing list stay amortized O(1) per retire()
+            next_reclaim_.store(std::max(reclaim_threshold, 2 * retired_.size()), std::memory_order_relaxed);
+
+            return no_of_reclaimed;
+        }
+
+        size_t no_of_retired() const
+        {
+            return retired_.size();
+        }
+
+        uint64_t epoch() const
+        {
+            return epoch_.load(std::memory_order_relaxed);
+        }
+
+    private:
+        static constexpr size_t reclaim_threshold = 128;
+
+        bool try_advance()
+        {
+            uint64_t epoch = epoch_.load(std::memory_order_seq_cst);
+
+            bool all_seen = true;
+            records_.for_each([epoch, &all_seen](const Record& record) {
+                const uint64_t pinned_epoch = record.pinned_epoch.load(std::memory_order_seq_cst);
+                if (pinned_epoch != not_pinned && pinned_epoch != epoch)
+                    all_seen = false;
+            });
+
+            return all_seen && epoch_.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst);
+        }
+
+        std::atomic<uint64_t> epoch_ {1};
+        std::atomic<size_t> next_reclaim_ {reclaim_threshold};
+        detail::RecordList<Record> records_;
+        detail::RetiredList retired_;
+    };
+}
+
+#endif // EPOCH_RECLAMATION_HPP
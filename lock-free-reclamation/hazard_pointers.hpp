@@ -0,0 +1,137 @@
+#ifndef HAZARD_POINTERS_HPP
+#define HAZARD_POINTERS_HPP
+
+#include "reclamation_detail.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace ext
+{
+    // Hazard pointers (Michael 2004):
+    //  - a reader publishes the pointer it is going to dereference in a hazard slot (Guard::protect())
+    //  - a retired object is freed only when no slot points to it - memory is bounded by
+    //    the number of slots (unlike EpochDomain, a stalled reader delays only the objects it protects)
+    //  - the domain must outlive all guards and all structures which retire objects in it;
+    //    objects still retired at the destruction of the domain are freed by its destructor
+    class HazardPointerDomain
+    {
+        struct Slot
+        {
+            std::atomic<const void*> hazard {nullptr};
+            std::atomic<bool> in_use {false};
+            Slot* next {nullptr};
+        };
+
+    public:
+        // owns one hazard slot of the domain
+        class Guard
+        {
+        public:
+            explicit Guard(HazardPointerDomain& domain = HazardPointerDomain::global())
+                : domain_ {domain}
+                , slot_ {domain.slots_.acquire()}
+            {
+            }
+
+            Guard(const Guard&) = delete;
+            Guard& operator=(const Guard&) = delete;
+
+            ~Guard()
+            {
+                reset();
+                domain_.slots_.release(slot_);
+            }
+
+            // returns the current value of src - it is not freed before reset() or the destruction of the guard
+            template <typename T>
+            T* protect(const std::atomic<T*>& src)
+            {
+                T* ptr = src.load(std::memory_order_relaxed);
+                while (true)
+                {
+                    slot_->hazard.store(ptr, std::memory_order_seq_cst);
+
+                    // still reachable after the publication - a reclaiming thread will see our hazard
+                    T* current = src.load(std::memory_order_seq_cst);
+                    if (current == ptr)
+                        return ptr;
+                    ptr = current;
+                }
+            }
+
+            void reset()
+            {
+                slot_->hazard.store(nullptr, std::memory_order_release);
+            }
+
+        private:
+            HazardPointerDomain& domain_;
+            Slot* slot_;
+        };
+
+        HazardPointerDomain() = default;
+        HazardPointerDomain(const HazardPointerDomain&) = delete;
+        HazardPointerDomain& operator=(const HazardPointerDomain&) = delete;
+
+        static HazardPointerDomain& global()
+        {
+            static HazardPointerDomain domain;
+            return domain;
+        }
+
+        // ptr must be unreachable for threads which do not protect it yet - it is deleted when no guard protects it
+        template <typename T>
+        void retire(T* ptr)
+        {
+            retire(ptr, &detail::delete_object<T>);
+        }
+
+        void retire(void* ptr, void (*deleter)(void*))
+        {
+            if (retired_.push(new detail::RetiredNode {ptr, deleter, 0, nullptr}) >= reclaim_threshold())
+                reclaim();
+        }
+
+        // frees the retired objects which are not protected - returns their number
+        size_t reclaim()
+        {
+            // the objects are taken before the scan - a guard which does not protect them at the scan
+            // can't protect them later (they were unlinked before retire())
+            detail::RetiredNode* retired = retired_.take_all();
+            if (!retired)
+                return 0;
+
+            std::vector<const void*> hazards;
+            slots_.for_each([&hazards](const Slot& slot) {
+                if (const void* hazard = slot.hazard.load(std::memory_order_seq_cst))
+                    hazards.push_back(hazard);
+            });
+            std::sort(hazards.begin(), hazards.end());
+
+            return retired_.reclaim_chain(retired, [&hazards](const detail::RetiredNode& node) {
+                return !std::binary_search(hazards.begin(), hazards.end(), static_cast<const void*>(node.ptr));
+            });
+        }
+
+        size_t no_of_retired() const
+        {
+            return retired_.size();
+        }
+
+    private:
+        // a scan frees at least half of the retired objects - amortized O(1) per retire()
+        size_t reclaim_threshold() const
+        {
+            return std::max<size_t>(2 * slots_.size(), 64);
+        }
+
+        // slots_ must be destroyed after retired_ - nothing is protected anymore
+        detail::RecordList<Slot> slots_;
+        detail::RetiredList retired_;
+    };
+}
+
+#endif // HAZARD_POINTERS_HPP
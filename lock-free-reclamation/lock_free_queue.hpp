@@ -0,0 +1,124 @@
+#ifndef LOCK_FREE_QUEUE_HPP
+#define LOCK_FREE_QUEUE_HPP
+
+#include "hazard_pointers.hpp"
+
+#include <atomic>
+#include <optional>
+#include <utility>
+
+// Michael-Scott queue - unbounded MPMC FIFO
+//  - head_ points to a dummy node, the first item is stored in its successor
+//  - tail_ may lag one node behind the last one - every thread which notices it helps to swing it
+//  - dequeued dummies are retired in Reclaimer (HazardPointerDomain or EpochDomain)
+template <typename T, typename Reclaimer = ext::HazardPointerDomain>
+class LockFreeQueue
+{
+    struct Node
+    {
+        std::optional<T> value;
+        std::atomic<Node*> next {nullptr};
+    };
+
+    std::atomic<Node*> head_;
+    std::atomic<Node*> tail_;
+    Reclaimer& reclaimer_;
+
+public:
+    explicit LockFreeQueue(Reclaimer& reclaimer = Reclaimer::global())
+        : reclaimer_ {reclaimer}
+    {
+        Node* dummy = new Node {};
+        head_.store(dummy, std::memory_order_relaxed);
+        tail_.store(dummy, std::memory_order_relaxed);
+    }
+
+    LockFreeQueue(const LockFreeQueue&) = delete;
+    LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+    // no other thread may use the queue
+    ~LockFreeQueue()
+    {
+        Node* node = head_.load(std::memory_order_relaxed);
+        while (node)
+        {
+            Node* next = node->next.load(std::memory_order_relaxed);
+            delete node;
+            node = next;
+        }
+    }
+
+    bool empty() const
+    {
+        typename Reclaimer::Guard guard {reclaimer_};
+        Node* head = guard.protect(head_);
+        return head->next.load() == nullptr;
+    }
+
+    void push(T item)
+    {
+        Node* node = new Node {};
+        node->value.emplace(std::move(item));
+
+        typename Reclaimer::Guard guard {reclaimer_};
+
+        while (true)
+        {
+            Node* tail = guard.protect(tail_);
+            Node* next = tail->next.load();
+
+            if (tail != tail_.load())
+                continue;
+
+            if (next)
+            {
+                tail_.compare_exchange_weak(tail, next); // help the push which has linked next
+                continue;
+            }
+
+            if (tail->next.compare_exchange_weak(next, node))
+            {
+                tail_.compare_exchange_strong(tail, node); // may fail - somebody has already helped
+                return;
+            }
+        }
+    }
+
+    bool try_pop(T& item)
+    {
+        typename Reclaimer::Guard guard_head {reclaimer_};
+        typename Reclaimer::Guard guard_next {reclaimer_};
+
+        while (true)
+        {
+            Node* head = guard_head.protect(head_);
+            Node* next = guard_next.protect(head->next);
+
+            if (head != head_.load()) // next might have been dequeued and freed before it was protected
+                continue;
+
+            if (!next)
+                return false;
+
+            Node* tail = tail_.load();
+            if (head == tail)
+            {
+                tail_.compare_exchange_weak(tail, next); // tail lags behind - the dummy can't be retired before it moves
+                continue;
+            }
+
+            // next becomes the new dummy - its value belongs to the thread which swung the head
+            if (head_.compare_exchange_weak(head, next))
+            {
+                item = std::move(*next->value);
+                next->value.reset();
+
+                guard_head.reset();
+                reclaimer_.retire(head);
+                return true;
+            }
+        }
+    }
+};
+
+#endif // LOCK_FREE_QUEUE_HPP
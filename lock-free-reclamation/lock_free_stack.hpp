@@ -0,0 +1,80 @@
+#ifndef LOCK_FREE_STACK_HPP
+#define LOCK_FREE_STACK_HPP
+
+#include "hazard_pointers.hpp"
+
+#include <atomic>
+#include <utility>
+
+// Treiber stack - push and pop are a single CAS on the head
+//  - popped nodes are retired in Reclaimer (HazardPointerDomain or EpochDomain) - a concurrent pop
+//    which still reads the node never touches freed memory and the ABA problem can't happen
+//    (an address is not reused while any thread protects it)
+template <typename T, typename Reclaimer = ext::HazardPointerDomain>
+class LockFreeStack
+{
+    struct Node
+    {
+        T value;
+        Node* next;
+    };
+
+    std::atomic<Node*> head_ {nullptr};
+    Reclaimer& reclaimer_;
+
+public:
+    explicit LockFreeStack(Reclaimer& reclaimer = Reclaimer::global())
+        : reclaimer_ {reclaimer}
+    {
+    }
+
+    LockFreeStack(const LockFreeStack&) = delete;
+    LockFreeStack& operator=(const LockFreeStack&) = delete;
+
+    // no other thread may use the stack
+    ~LockFreeStack()
+    {
+        Node* node = head_.load(std::memory_order_relaxed);
+        while (node)
+        {
+            Node* next = node->next;
+            delete node;
+            node = next;
+        }
+    }
+
+    bool empty() const
+    {
+        return head_.load() == nullptr;
+    }
+
+    void push(T item)
+    {
+        Node* node = new Node {std::move(item), head_.load(std::memory_order_relaxed)};
+        while (!head_.compare_exchange_weak(node->next, node))
+            ;
+    }
+
+    bool try_pop(T& item)
+    {
+        typename Reclaimer::Guard guard {reclaimer_};
+
+        while (true)
+        {
+            Node* top = guard.protect(head_);
+            if (!top)
+                return false;
+
+            // top can't be freed while it is protected, so top->next is still the successor if the CAS succeeds
+            if (head_.compare_exchange_weak(top, top->next))
+            {
+                item = std::move(top->value);
+                guard.reset();
+                reclaimer_.retire(top);
+                return true;
+            }
+        }
+    }
+};
+
+#endif // LOCK_FREE_STACK_HPP
@@ -0,0 +1,241 @@
+#ifndef RECLAMATION_DETAIL_HPP
+#define RECLAMATION_DETAIL_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace ext::detail
+{
+    // Lock-free list of records (hazard slots, epoch records) shared by the threads of a domain:
+    //  - records are never removed before the domain is destroyed - a released record is reused by the next acquire()
+    //  - every thread remembers a few records it used lately, so acquire() rarely walks the list
+    // Record must have: std::atomic<bool> in_use; Record* next;
+    template <typename Record>
+    class RecordList
+    {
+    public:
+        RecordList() = default;
+        RecordList(const RecordList&) = delete;
+        RecordList& operator=(const RecordList&) = delete;
+
+        ~RecordList()
+        {
+            Record* record = head_.load(std::memory_order_acquire);
+            while (record)
+            {
+                Record* next = record->next;
+                delete record;
+                record = next;
+            }
+        }
+
+        Record* acquire()
+        {
+            Hints& hints = this_thread_hints();
+            if (hints.list_id != id_)
+                hints = Hints {id_, {}, 0};
+
+            for (Record* record : hints.records)
+            {
+                if (record && try_acquire(*record))
+                    return record;
+            }
+
+            for (Record* record = head_.load(std::memory_order_acquire); record; record = record->next)
+            {
+                if (try_acquire(*record))
+                {
+                    remember(hints, record);
+                    return record;
+                }
+            }
+
+            auto* record = new Record {};
+            record->in_use.store(true, std::memory_order_relaxed);
+            record->next = head_.load(std::memory_order_relaxed);
+            while (!head_.compare_exchange_weak(record->next, record, std::memory_order_release, std::memory_order_relaxed))
+                ;
+            size_.fetch_add(1, std::memory_order_relaxed);
+
+            remember(hints, record);
+            return record;
+        }
+
+        void release(Record* record)
+        {
+            record->in_use.store(false, std::memory_order_release);
+        }
+
+        // visits all records - also the ones which are not in use
+        template <typename Visitor>
+        void for_each(Visitor visitor) const
+        {
+            for (Record* record = head_.load(std::memory_order_acquire); record; record = record->next)
+                visitor(*record);
+        }
+
+        size_t size() const
+        {
+            return size_.load(std::memory_order_relaxed);
+        }
+
+    private:
+        struct Hints
+        {
+            uint64_t list_id;
+            std::array<Record*, 4> records;
+            size_t next_to_replace;
+        };
+
+        // ids are never reused - hints of a destroyed list are never dereferenced
+        static uint64_t next_id()
+        {
+            static std::atomic<uint64_t> last_id {0};
+            return last_id.fetch_add(1, std::memory_order_relaxed) + 1;
+        }
+
+        static Hints& this_thread_hints()
+        {
+            thread_local Hints hints {0, {}, 0};
+            return hints;
+        }
+
+        static bool try_acquire(Record& record)
+        {
+            return !record.in_use.load(std::memory_order_relaxed) && !record.in_use.exchange(true, std::memory_order_acquire);
+        }
+
+        static void remember(Hints& hints, Record* record)
+        {
+            hints.records[hints.next_to_replace] = record;
+            hints.next_to_replace = (hints.next_to_replace + 1) % hints.records.size();
+        }
+
+        std::atomic<Record*> head_ {nullptr};
+        std::atomic<size_t> size_ {0};
+        const uint64_t id_ {next_id()};
+    };
+
+    struct RetiredNode
+    {
+        void* ptr;
+        void (*deleter)(void*);
+        uint64_t epoch; // used by EpochDomain only
+        RetiredNode* next;
+    };
+
+    // lock-free list of retired objects - any thread may take all of them and give back the ones still in use
+    class RetiredList
+    {
+    public:
+        RetiredList() = default;
+        RetiredList(const RetiredList&) = delete;
+        RetiredList& operator=(const RetiredList&) = delete;
+
+        // no thread may use the retired objects anymore
+        ~RetiredList()
+        {
+            RetiredNode* node = take_all();
+            while (node)
+            {
+                RetiredNode* next = node->next;
+                node->deleter(node->ptr);
+                delete node;
+                node = next;
+            }
+        }
+
+        // returns the number of retired objects after the push
+        size_t push(RetiredNode* node)
+        {
+            push_chain(node, node, 1);
+            return size();
+        }
+
+        void push_chain(RetiredNode* first, RetiredNode* last, size_t count)
+        {
+            last->next = head_.load(std::memory_order_relaxed);
+            while (!head_.compare_exchange_weak(last->next, first, std::memory_order_release, std::memory_order_relaxed))
+                ;
+            size_.fetch_add(static_cast<std::ptrdiff_t>(count), std::memory_order_relaxed);
+        }
+
+        // the caller becomes the owner of the whole chain
+        RetiredNode* take_all()
+        {
+            RetiredNode* first = head_.exchange(nullptr, std::memory_order_acquire);
+
+            size_t count = 0;
+            for (RetiredNode* node = first; node; node = node->next)
+                ++count;
+            size_.fetch_sub(static_cast<std::ptrdiff_t>(count), std::memory_order_relaxed);
+
+            return first;
+        }
+
+        // frees the objects for which is_free(node) is true and gives back the other ones
+        template <typename Predicate>
+        size_t reclaim_if(Predicate is_free)
+        {
+            return reclaim_chain(take_all(), is_free);
+        }
+
+        // reclaim_if() for a chain taken by take_all()
+        template <typename Predicate>
+        size_t reclaim_chain(RetiredNode* node, Predicate is_free)
+        {
+            RetiredNode* kept_first = nullptr;
+            RetiredNode* kept_last = nullptr;
+            size_t no_of_kept = 0;
+            size_t no_of_reclaimed = 0;
+
+            while (node)
+            {
+                RetiredNode* next = node->next;
+
+                if (is_free(*node))
+                {
+                    node->deleter(node->ptr);
+                    delete node;
+                    ++no_of_reclaimed;
+                }
+                else
+                {
+                    node->next = kept_first;
+                    kept_first = node;
+                    if (!kept_last)
+                        kept_last = node;
+                    ++no_of_kept;
+                }
+
+                node = next;
+            }
+
+            if (kept_first)
+                push_chain(kept_first, kept_last, no_of_kept);
+
+            return no_of_reclaimed;
+        }
+
+        // approximate while other threads push or reclaim
+        size_t size() const
+        {
+            const std::ptrdiff_t size = size_.load(std::memory_order_relaxed);
+            return size > 0 ? static_cast<size_t>(size) : 0;
+        }
+
+    private:
+        std::atomic<RetiredNode*> head_ {nullptr};
+        std::atomic<std::ptrdiff_t> size_ {0}; // may be negative for a moment - a node is taken before it is counted
+    };
+
+    template <typename T>
+    void delete_object(void* ptr)
+    {
+        delete static_cast<T*>(ptr);
+    }
+}
+
+#endif // RECLAMATION_DETAIL_HPP
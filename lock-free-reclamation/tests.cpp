@@ -0,0 +1,401 @@
+#include "catch.hpp"
+#include "epoch_reclamation.hpp"
+#include "hazard_pointers.hpp"
+#include "lock_free_queue.hpp"
+#include "lock_free_stack.hpp"
+#include "thread_safe_queue.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace ext;
+
+namespace
+{
+    struct Tracked
+    {
+        static inline std::atomic<int> no_of_alive {0};
+
+        int value;
+
+        explicit Tracked(int value = 0)
+            : value {value}
+        {
+            ++no_of_alive;
+        }
+
+        Tracked(const Tracked& other)
+            : value {other.value}
+        {
+            ++no_of_alive;
+        }
+
+        Tracked& operator=(const Tracked&) = default;
+
+        ~Tracked()
+        {
+            --no_of_alive;
+        }
+    };
+
+    // every producer pushes no_of_items values from 1..no_of_items, consumers pop until all of them are taken
+    template <typename Container>
+    long long run_producers_consumers(Container& container, int no_of_producers, int no_of_consumers, int no_of_items)
+    {
+        std::atomic<int> no_of_popped {0};
+        std::atomic<long long> sum {0};
+        const int no_of_all = no_of_producers * no_of_items;
+
+        std::vector<std::thread> threads;
+
+        for (int p = 0; p < no_of_producers; ++p)
+            threads.emplace_back([&] {
+                for (int i = 1; i <= no_of_items; ++i)
+                    container.push(i);
+            });
+
+        for (int c = 0; c < no_of_consumers; ++c)
+            threads.emplace_back([&] {
+                long long local_sum = 0;
+                int item;
+                while (no_of_popped.load() < no_of_all)
+                {
+                    if (container.try_pop(item))
+                    {
+                        local_sum += item;
+                        ++no_of_popped;
+                    }
+                    else
+                        std::this_thread::yield();
+                }
+                sum += local_sum;
+            });
+
+        for (auto& thd : threads)
+            thd.join();
+
+        return sum.load();
+    }
+}
+
+TEST_CASE("HazardPointerDomain")
+{
+    HazardPointerDomain domain;
+
+    SECTION("protected object is not freed by reclaim")
+    {
+        std::atomic<Tracked*> src {new Tracked {42}};
+
+        {
+            HazardPointerDomain::Guard guard {domain};
+            Tracked* ptr = guard.protect(src);
+            REQUIRE(ptr->value == 42);
+
+            src.store(nullptr);
+            domain.retire(ptr);
+
+            REQUIRE(domain.reclaim() == 0);
+            REQUIRE(domain.no_of_retired() == 1);
+            REQUIRE(Tracked::no_of_alive == 1);
+        }
+
+        REQUIRE(domain.reclaim() == 1);
+        REQUIRE(domain.no_of_retired() == 0);
+        REQUIRE(Tracked::no_of_alive == 0);
+    }
+
+    SECTION("reset releases the protection")
+    {
+        std::atomic<Tracked*> src {new Tracked {1}};
+
+        HazardPointerDomain::Guard guard {domain};
+        Tracked* ptr = guard.protect(src);
+        src.store(nullptr);
+        domain.retire(ptr);
+
+        guard.reset();
+
+        REQUIRE(domain.reclaim() == 1);
+        REQUIRE(Tracked::no_of_alive == 0);
+    }
+
+    SECTION("released slots are reused")
+    {
+        for (int i = 0; i < 100; ++i)
+        {
+            HazardPointerDomain::Guard guard_1 {domain};
+            HazardPointerDomain::Guard guard_2 {domain};
+        }
+
+        REQUIRE(domain.no_of_retired() == 0);
+    }
+
+    SECTION("retired objects are freed by the destructor of the domain")
+    {
+        {
+            HazardPointerDomain local_domain;
+            local_domain.retire(new Tracked {1});
+            local_domain.retire(new Tracked {2});
+
+            REQUIRE(Tracked::no_of_alive == 2);
+        }
+
+        REQUIRE(Tracked::no_of_alive == 0);
+    }
+}
+
+TEST_CASE("EpochDomain")
+{
+    EpochDomain domain;
+
+    SECTION("object is not freed while a guard pinned before its retirement exists")
+    {
+        std::atomic<Tracked*> src {new Tracked {42}};
+
+        {
+            EpochDomain::Guard guard {domain};
+            Tracked* ptr = guard.protect(src);
+
+            src.store(nullptr);
+            domain.retire(ptr);
+
+            for (int i = 0; i < 10; ++i)
+                REQUIRE(domain.reclaim() == 0);
+
+            REQUIRE(ptr->value == 42);
+            REQUIRE(Tracked::no_of_alive == 1);
+        }
+
+        domain.reclaim();
+        domain.reclaim();
+
+        REQUIRE(domain.no_of_retired() == 0);
+        REQUIRE(Tracked::no_of_alive == 0);
+    }
+
+    SECTION("epoch advances only when all pinned guards have seen it")
+    {
+        const uint64_t start_epoch = domain.epoch();
+
+        {
+            EpochDomain::Guard guard {domain};
+
+            domain.reclaim();
+            REQUIRE(domain.epoch() == start_epoch + 1);
+
+            domain.reclaim();
+            domain.reclaim();
+            REQUIRE(domain.epoch() == start_epoch + 1);
+        }
+
+        domain.reclaim();
+        REQUIRE(domain.epoch() == start_epoch + 2);
+    }
+
+    SECTION("retired objects are freed by the destructor of the domain")
+    {
+        {
+            EpochDomain local_domain;
+            EpochDomain::Guard guard {local_domain};
+            local_domain.retire(new Tracked {1});
+        }
+
+        REQUIRE(Tracked::no_of_alive == 0);
+    }
+}
+
+TEMPLATE_TEST_CASE("LockFreeStack", "[stack]", HazardPointerDomain, EpochDomain)
+{
+    TestType domain;
+
+    SECTION("try_pop on empty stack returns false")
+    {
+        LockFreeStack<int, TestType> stack {domain};
+
+        int item;
+        REQUIRE(stack.empty());
+        REQUIRE(stack.try_pop(item) == false);
+    }
+
+    SECTION("items are popped in LIFO order")
+    {
+        LockFreeStack<std::string, TestType> stack {domain};
+
+        stack.push("one");
+        stack.push("two");
+        stack.push("three");
+
+        std::string item;
+        REQUIRE(stack.try_pop(item));
+        REQUIRE(item == "three");
+        REQUIRE(stack.try_pop(item));
+        REQUIRE(item == "two");
+        REQUIRE(stack.try_pop(item));
+        REQUIRE(item == "one");
+        REQUIRE(stack.empty());
+    }
+
+    SECTION("concurrent push & pop - every item is popped once")
+    {
+        LockFreeStack<int, TestType> stack {domain};
+
+        const long long sum = run_producers_consumers(stack, 4, 4, 20'000);
+
+        REQUIRE(sum == 4 * (20'000LL * 20'001 / 2));
+        REQUIRE(stack.empty());
+    }
+
+    SECTION("all values are destroyed when the stack and its domain are destroyed")
+    {
+        {
+            TestType local_domain;
+            LockFreeStack<Tracked, TestType> stack {local_domain};
+
+            std::vector<std::thread> threads;
+            for (int t = 0; t < 4; ++t)
+                threads.emplace_back([&stack] {
+                    Tracked item;
+                    for (int i = 0; i < 10'000; ++i)
+                    {
+                        stack.push(Tracked {i});
+                        if (i % 2 == 0)
+                            stack.try_pop(item);
+                    }
+                });
+
+            for (auto& thd : threads)
+                thd.join();
+        }
+
+        REQUIRE(Tracked::no_of_alive == 0);
+    }
+}
+
+TEMPLATE_TEST_CASE("LockFreeQueue", "[queue]", HazardPointerDomain, EpochDomain)
+{
+    TestType domain;
+
+    SECTION("try_pop on empty queue returns false")
+    {
+        LockFreeQueue<int, TestType> queue {domain};
+
+        int item;
+        REQUIRE(queue.empty());
+        REQUIRE(queue.try_pop(item) == false);
+    }
+
+    SECTION("items are popped in FIFO order")
+    {
+        LockFreeQueue<std::string, TestType> queue {domain};
+
+        queue.push("one");
+        queue.push("two");
+        queue.push("three");
+
+        std::string item;
+        REQUIRE(queue.try_pop(item));
+        REQUIRE(item == "one");
+        REQUIRE(queue.try_pop(item));
+        REQUIRE(item == "two");
+        REQUIRE(queue.try_pop(item));
+        REQUIRE(item == "three");
+        REQUIRE(queue.empty());
+    }
+
+    SECTION("items of one producer are popped in its push order")
+    {
+        LockFreeQueue<int, TestType> queue {domain};
+
+        std::thread producer {[&queue] {
+            for (int i = 0; i < 50'000; ++i)
+                queue.push(i);
+        }};
+
+        int expected = 0;
+        int item;
+        while (expected < 50'000)
+        {
+            if (queue.try_pop(item))
+            {
+                REQUIRE(item == expected);
+                ++expected;
+            }
+        }
+
+        producer.join();
+    }
+
+    SECTION("concurrent push & pop - every item is popped once")
+    {
+        LockFreeQueue<int, TestType> queue {domain};
+
+        const long long sum = run_producers_consumers(queue, 4, 4, 20'000);
+
+        REQUIRE(sum == 4 * (20'000LL * 20'001 / 2));
+        REQUIRE(queue.empty());
+    }
+
+    SECTION("all values are destroyed when the queue and its domain are destroyed")
+    {
+        {
+            TestType local_domain;
+            LockFreeQueue<Tracked, TestType> queue {local_domain};
+
+            std::vector<std::thread> threads;
+            for (int t = 0; t < 4; ++t)
+                threads.emplace_back([&queue] {
+                    Tracked item;
+                    for (int i = 0; i < 10'000; ++i)
+                    {
+                        queue.push(Tracked {i});
+                        if (i % 2 == 0)
+                            queue.try_pop(item);
+                    }
+                });
+
+            for (auto& thd : threads)
+                thd.join();
+        }
+
+        REQUIRE(Tracked::no_of_alive == 0);
+    }
+}
+
+namespace
+{
+    template <typename Queue>
+    void benchmark_queue(const std::string& name, int no_of_threads, int no_of_items)
+    {
+        Queue queue;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        const long long sum = run_producers_consumers(queue, no_of_threads, no_of_threads, no_of_items);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        std::cout << name << " - " << no_of_threads << " producers & consumers: elapsed = "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms (sum = " << sum << ")" << std::endl;
+    }
+}
+
+// run: ./lock-free-reclamation [benchmark]
+TEST_CASE("Throughput - lock-free queue vs. ThreadSafeQueue", "[.][benchmark]")
+{
+    const int no_of_items = 1'000'000;
+
+    for (int no_of_threads : {1, 2, 4})
+    {
+        benchmark_queue<ThreadSafeQueue<int>>("ThreadSafeQueue", no_of_threads, no_of_items);
+        benchmark_queue<LockFreeQueue<int, HazardPointerDomain>>("LockFreeQueue<HP>", no_of_threads, no_of_items);
+        benchmark_queue<LockFreeQueue<int, EpochDomain>>("LockFreeQueue<EBR>", no_of_threads, no_of_items);
+        benchmark_queue<LockFreeStack<int, HazardPointerDomain>>("LockFreeStack<HP>", no_of_threads, no_of_items);
+        benchmark_queue<LockFreeStack<int, EpochDomain>>("LockFreeStack<EBR>", no_of_threads, no_of_items);
+        std::cout << std::endl;
+    }
+}
@@ -1,8 +1,16 @@
+#include <array>
 #include <atomic>
 #include <boost/intrusive_ptr.hpp>
 #include <boost/noncopyable.hpp>
+#include <chrono>
+#include <future>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
 #include <thread>
+#include <vector>
 
 // definicja funkcji intrusive_ptr_add_ref i intrusive_ptr_release
 template <typename T>
@@ -69,6 +77,185 @@ namespace ThreadSafe
     };
 }
 
+namespace Biased
+{
+    // biased reference counting (Choi, Shull, Torrellas - PACT 2018):
+    //  - watek, ktory utworzyl obiekt (wlasciciel), zmienia nieatomowy licznik biased_count_
+    //  - pozostale watki zmieniaja atomowy licznik shared_ (moze byc ujemny - zwalniaja referencje
+    //    utworzone przez wlasciciela)
+    //  - liczniki sa scalane (bit merged w shared_), gdy biased_count_ spadnie do zera albo gdy shared_
+    //    stanie sie ujemny - wtedy watek zwalniajacy ustawia bit queued (w tej samej operacji RMW)
+    //    i prosi wlasciciela o scalenie; wlasciciel robi to przy swojej nastepnej operacji na licznikach
+    //    lub przy zakonczeniu watku
+    //  - dopoki bit queued jest ustawiony, obiekt usuwa tylko jawne scalenie z kolejki - niejawne
+    //    scalenie wlasciciela i zwolnienia innych watkow go nie usuwaja
+    //  - po scaleniu wszystkie watki (rowniez wlasciciel) uzywaja tylko shared_
+    class RefCountedBase;
+
+    namespace detail
+    {
+        // kolejka obiektow do scalenia - jedna na watek wlasciciela
+        struct OwnerState
+        {
+            std::mutex mtx;
+            std::vector<RefCountedBase*> merge_queue;
+            std::atomic<bool> has_queued {false};
+            bool alive {true};
+
+            void drain();
+        };
+
+        // konczacy sie watek scala obiekty z kolejki; pozniejsze prosby scala watek proszacy
+        struct OwnerHandle
+        {
+            std::shared_ptr<OwnerState> state {std::make_shared<OwnerState>()};
+
+            ~OwnerHandle()
+            {
+                std::lock_guard<std::mutex> lk {state->mtx};
+                state->alive = false;
+                state->drain();
+            }
+        };
+
+        inline const std::shared_ptr<OwnerState>& this_thread_owner_state()
+        {
+            thread_local OwnerHandle handle;
+            return handle.state;
+        }
+    }
+
+    class RefCountedBase : boost::noncopyable
+    {
+        friend struct detail::OwnerState;
+
+        static constexpr int merged = 1;
+        static constexpr int queued = 2;
+        static constexpr int one = 4; // licznik jest zapisany w bitach 2..31
+
+        const std::shared_ptr<detail::OwnerState> owner_ {detail::this_thread_owner_state()};
+        int biased_count_ {0};
+        bool owner_merged_ {false}; // zmieniane tylko przez wlasciciela (lub po zakonczeniu jego watku)
+        std::atomic<int> shared_ {0};
+        void (*destroy_)(RefCountedBase*);
+
+        // wlasciciel najpierw scala obiekty, o ktore poproszono - rowniez ten (nie zostanie usuniety,
+        // bo referencja, na ktorej dzialamy, jest jeszcze policzona)
+        bool is_owner()
+        {
+            if (owner_.get() != detail::this_thread_owner_state().get())
+                return false;
+
+            if (owner_->has_queued.load(std::memory_order_acquire))
+                owner_->drain();
+
+            return !owner_merged_;
+        }
+
+        // niejawne scalenie (biased_count_ == 0) - obiekt w kolejce usunie jawne scalenie
+        void merge()
+        {
+            owner_merged_ = true;
+            if (shared_.fetch_add(merged, std::memory_order_acq_rel) == 0)
+                destroy_(this);
+        }
+
+        // jawne scalenie obiektu z kolejki: przenosi biased_count_ do shared_, ustawia bit merged
+        // (o ile niejawne scalenie go nie ustawilo) i kasuje bit queued
+        void merge_queued()
+        {
+            const int delta = biased_count_ * one + (owner_merged_ ? 0 : merged) - queued;
+            owner_merged_ = true;
+            biased_count_ = 0;
+            if (shared_.fetch_add(delta, std::memory_order_acq_rel) + delta == merged)
+                destroy_(this);
+        }
+
+        // bit queued jest juz ustawiony - obiekt nie zostanie usuniety przed merge_queued()
+        void request_merge()
+        {
+            {
+                std::lock_guard<std::mutex> lk {owner_->mtx};
+                if (owner_->alive)
+                {
+                    owner_->merge_queue.push_back(this);
+                    owner_->has_queued.store(true, std::memory_order_release);
+                    return;
+                }
+            }
+
+            merge_queued(); // watek wlasciciela juz sie zakonczyl - nie zmienia biased_count_
+        }
+
+    protected:
+        explicit RefCountedBase(void (*destroy)(RefCountedBase*))
+            : destroy_ {destroy}
+        {
+        }
+
+        ~RefCountedBase() = default;
+
+    public:
+        void add_ref()
+        {
+            if (is_owner())
+                ++biased_count_;
+            else
+                shared_.fetch_add(one, std::memory_order_relaxed);
+        }
+
+        void release()
+        {
+            if (is_owner())
+            {
+                if (--biased_count_ == 0)
+                    merge();
+                return;
+            }
+
+            // 0 -> -1 przed scaleniem ustawia rowniez bit queued
+            int previous = shared_.load(std::memory_order_relaxed);
+            while (!shared_.compare_exchange_weak(previous, previous == 0 ? queued - one : previous - one,
+                std::memory_order_acq_rel, std::memory_order_relaxed))
+            {
+            }
+
+            if (previous == one + merged)
+                destroy_(this);
+            else if (previous == 0)
+                request_merge();
+        }
+    };
+
+    namespace detail
+    {
+        inline void OwnerState::drain()
+        {
+            std::vector<RefCountedBase*> objects;
+            {
+                std::unique_lock<std::mutex> lk {mtx, std::defer_lock};
+                if (alive)
+                    lk.lock(); // przy zakonczeniu watku mutex jest juz zablokowany
+                objects.swap(merge_queue);
+                has_queued.store(false, std::memory_order_relaxed);
+            }
+
+            for (auto* object : objects)
+                object->merge_queued();
+        }
+    }
+
+    template <typename T>
+    class RefCounted : public RefCountedBase
+    {
+    public:
+        RefCounted()
+            : RefCountedBase {[](RefCountedBase* base) { delete static_cast<T*>(static_cast<RefCounted*>(base)); }}
+        {
+        }
+    };
+}
+
 // zarzadzana klasa
 class Gadget : public ThreadSafe::RefCounted<Gadget>
 {
@@ -87,6 +274,149 @@ public:
     }
 };
 
+class BiasedGadget : public Biased::RefCounted<BiasedGadget>
+{
+public:
+    BiasedGadget()
+    {
+        std::cout << "BiasedGadget::BiasedGadget()\n";
+    }
+
+    ~BiasedGadget()
+    {
+        std::cout << "BiasedGadget::~BiasedGadget()\n";
+    }
+};
+
+// obiekt bez wypisywania komunikatow - do benchmarku
+template <template <typename> class RefCountedT>
+struct Widget : RefCountedT<Widget<RefCountedT>>
+{
+    int value {42};
+};
+
+// kazdy watek kopiuje no_of_copies razy uchwyty do:
+//  - own    - obiektu utworzonego przez ten watek (sciezka wlasciciela w Biased)
+//  - shared - jednego obiektu utworzonego przez main (wszystkie watki na jednej linii cache)
+template <template <typename> class RefCountedT>
+void benchmark_ref_counting(const std::string& name, size_t no_of_threads, size_t no_of_copies)
+{
+    using Ptr = boost::intrusive_ptr<Widget<RefCountedT>>;
+
+    auto copy_many = [no_of_copies](const Ptr& source) {
+        std::array<Ptr, 16> copies;
+        long sum = 0;
+        for (size_t i = 0; i < no_of_copies; ++i)
+        {
+            copies[i % copies.size()] = source;
+            sum += copies[i % copies.size()]->value;
+        }
+        return sum;
+    };
+
+    auto run = [&](const std::string& scenario, auto body) {
+        std::vector<std::thread> threads;
+        std::vector<long> sums(no_of_threads);
+
+        const auto start = std::chrono::high_resolution_clock::now();
+
+        for (size_t t = 0; t < no_of_threads; ++t)
+            threads.emplace_back([&, t] { sums[t] = body(); });
+        for (auto& thd : threads)
+            thd.join();
+
+        const auto end = std::chrono::high_resolution_clock::now();
+
+        std::cout << name << " - " << scenario << " - threads: " << no_of_threads << "; elapsed = "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms" << std::endl;
+    };
+
+    run("own", [&] { return copy_many(Ptr {new Widget<RefCountedT>()}); });
+
+    Ptr shared {new Widget<RefCountedT>()};
+    run("shared", [&] { return copy_many(shared); });
+}
+
+// zycie obiektow Biased::RefCounted - liczone przez stress_biased_merge()
+struct TrackedWidget : Biased::RefCounted<TrackedWidget>
+{
+    static inline std::atomic<int> no_of_alive {0};
+
+    TrackedWidget()
+    {
+        ++no_of_alive;
+    }
+
+    ~TrackedWidget()
+    {
+        --no_of_alive;
+    }
+};
+
+// wyscig prosby o scalenie z niejawnym scaleniem wlasciciela (uruchamiac tez z -fsanitize=address/thread):
+//  - releaser zwalnia referencje wlasciciela (shared_: 0 -> -1) i prosi o scalenie
+//  - copier tworzy dwie referencje (shared_ wraca do 0) i oddaje je wlascicielowi
+//  - wlasciciel zwalnia wszystkie swoje referencje - biased_count_ spada do 0, gdy obiekt moze byc
+//    jeszcze w kolejce do scalenia
+bool stress_biased_merge(size_t no_of_iterations)
+{
+    using Ptr = boost::intrusive_ptr<TrackedWidget>;
+
+    std::mt19937 rnd {665};
+    std::uniform_int_distribution<unsigned> delay_distr {0, 63};
+
+    for (size_t i = 0; i < no_of_iterations; ++i)
+    {
+        const unsigned delays[3] = {delay_distr(rnd), delay_distr(rnd), delay_distr(rnd)};
+        auto spin = [](unsigned n) {
+            for (volatile unsigned k = 0; k < n; ++k)
+            {
+            }
+        };
+
+        std::thread owner {[&] {
+            Ptr p {new TrackedWidget()};
+            Ptr for_releaser = p;
+            Ptr for_copier = p;
+
+            std::promise<std::array<Ptr, 2>> copies_promise;
+            auto copies = copies_promise.get_future();
+            std::atomic<bool> done {false};
+
+            std::thread releaser {[&, ptr = std::move(for_releaser)]() mutable {
+                spin(delays[0]);
+                ptr.reset();
+            }};
+
+            std::thread copier {[&, ptr = std::move(for_copier)]() mutable {
+                spin(delays[1]);
+                copies_promise.set_value({ptr, ptr});
+                ptr.reset();
+            }};
+
+            spin(delays[2]);
+            p.reset();
+            copies.get(); // otrzymane kopie sa od razu zwalniane
+
+            // kolejne operacje wlasciciela oprozniaja jego kolejke
+            Ptr other {new TrackedWidget()};
+            std::thread finisher {[&] {
+                releaser.join();
+                copier.join();
+                done = true;
+            }};
+            while (!done)
+                Ptr copy = other;
+
+            finisher.join();
+        }};
+
+        owner.join();
+    }
+
+    return TrackedWidget::no_of_alive == 0;
+}
+
 int main()
 {
     using namespace std;
@@ -105,4 +435,25 @@ int main()
 
     thd1.join();
     thd2.join();
+
+    // referencje utworzone w main (wlasciciel) zwolnione przez inne watki - main scala liczniki
+    // przy swojej nastepnej operacji na licznikach
+    {
+        boost::intrusive_ptr<BiasedGadget> p {new BiasedGadget()};
+        std::thread thd3 {[p] { std::this_thread::sleep_for(100ms); }};
+        std::thread thd4 {[p] { std::this_thread::sleep_for(200ms); }};
+        p.reset();
+        thd3.join();
+        thd4.join();
+
+        boost::intrusive_ptr<BiasedGadget> other {new BiasedGadget()};
+    }
+
+    cout << "Biased::RefCounted - merge stress - all objects destroyed: " << boolalpha << stress_biased_merge(20'000) << endl;
+
+    for (size_t no_of_threads : {1, 2, 4, 8, 16, 32, 64})
+    {
+        benchmark_ref_counting<ThreadSafe::RefCounted>("ThreadSafe::RefCounted", no_of_threads, 10'000'000 / no_of_threads);
+        benchmark_ref_counting<Biased::RefCounted>("Biased::RefCounted", no_of_threads, 10'000'000 / no_of_threads);
+    }
 }
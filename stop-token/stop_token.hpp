@@ -2,22 +2,202 @@
 #define STOP_TOKEN_HPP
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
 
 namespace ext
 {
-    struct SharedState
+    namespace detail
     {
-        std::atomic<bool> stop_requested_ {false};
+        struct StopCallbackBase
+        {
+            void (*invoke_)(StopCallbackBase*);
+            StopCallbackBase* next_ {nullptr};
+            StopCallbackBase** prev_ {nullptr}; // address of the pointer which points to this node
+            bool* destroyed_ {nullptr}; // set while the callback is running
+            std::atomic<bool> finished_ {false};
+
+            explicit StopCallbackBase(void (*invoke)(StopCallbackBase*))
+                : invoke_ {invoke}
+            {
+            }
+        };
+    }
+
+    // Shared state of StopSource/StopToken/StopCallback
+    //  - the stop flag and a spin lock guarding the list of callbacks live in one atomic word,
+    //    so request_stop() sets the flag and takes the list in a single CAS, and stop_requested() is one load
+    //  - the lock is held only for a few pointer operations (never while a callback runs)
+    class StopState
+    {
+        static constexpr uint32_t stop_requested_bit = 1;
+        static constexpr uint32_t locked_bit = 2;
+
+        std::atomic<uint32_t> state_ {0};
+        detail::StopCallbackBase* head_ {nullptr};
+        std::thread::id requesting_thread_;
+
+    public:
+        bool stop_requested() const
+        {
+            return state_.load(std::memory_order_acquire) & stop_requested_bit;
+        }
+
+        // returns false if stop was already requested (callback has not been registered)
+        bool try_add_callback(detail::StopCallbackBase* callback)
+        {
+            if (!lock_unless_stop_requested())
+                return false;
+
+            callback->next_ = head_;
+            callback->prev_ = &head_;
+            if (head_)
+                head_->prev_ = &callback->next_;
+            head_ = callback;
+
+            unlock();
+            return true;
+        }
+
+        // after return the callback is not running and will never be invoked
+        void remove_callback(detail::StopCallbackBase* callback)
+        {
+            lock();
+
+            if (callback->prev_)
+            {
+                // still registered - not invoked yet
+                *callback->prev_ = callback->next_;
+                if (callback->next_)
+                    callback->next_->prev_ = callback->prev_;
+                unlock();
+                return;
+            }
+
+            unlock();
+
+            // callback has been invoked or is running right now
+            if (requesting_thread_ == std::this_thread::get_id())
+            {
+                // destroyed from inside the callback (or after it on the same thread) - no need to wait
+                if (callback->destroyed_)
+                    *callback->destroyed_ = true;
+            }
+            else
+            {
+                while (!callback->finished_.load(std::memory_order_acquire))
+                    std::this_thread::yield();
+            }
+        }
+
+        // returns false if stop was already requested
+        bool request_stop()
+        {
+            uint32_t current = state_.load(std::memory_order_relaxed);
+
+            do
+            {
+                if (current & stop_requested_bit)
+                    return false;
+
+                if (current & locked_bit)
+                {
+                    std::this_thread::yield();
+                    current = state_.load(std::memory_order_relaxed);
+                    continue;
+                }
+            } while (!state_.compare_exchange_weak(current, stop_requested_bit | locked_bit,
+                std::memory_order_acq_rel, std::memory_order_relaxed));
+
+            requesting_thread_ = std::this_thread::get_id();
+
+            while (head_)
+            {
+                detail::StopCallbackBase* callback = head_;
+                head_ = callback->next_;
+                if (head_)
+                    head_->prev_ = &head_;
+                callback->prev_ = nullptr; // marks callback as invoked
+
+                bool destroyed = false;
+                callback->destroyed_ = &destroyed;
+
+                unlock();
+                callback->invoke_(callback);
+
+                if (!destroyed)
+                {
+                    callback->destroyed_ = nullptr;
+                    callback->finished_.store(true, std::memory_order_release);
+                }
+
+                lock();
+            }
+
+            unlock();
+            return true;
+        }
+
+    private:
+        void lock()
+        {
+            uint32_t current = state_.load(std::memory_order_relaxed);
+
+            while (true)
+            {
+                if (current & locked_bit)
+                {
+                    std::this_thread::yield();
+                    current = state_.load(std::memory_order_relaxed);
+                }
+                else if (state_.compare_exchange_weak(current, current | locked_bit,
+                             std::memory_order_acquire, std::memory_order_relaxed))
+                    return;
+            }
+        }
+
+        bool lock_unless_stop_requested()
+        {
+            uint32_t current = state_.load(std::memory_order_relaxed);
+
+            while (true)
+            {
+                if (current & stop_requested_bit)
+                    return false;
+
+                if (current & locked_bit)
+                {
+                    std::this_thread::yield();
+                    current = state_.load(std::memory_order_relaxed);
+                }
+                else if (state_.compare_exchange_weak(current, current | locked_bit,
+                             std::memory_order_acquire, std::memory_order_relaxed))
+                    return true;
+            }
+        }
+
+        void unlock()
+        {
+            state_.fetch_and(~locked_bit, std::memory_order_release);
+        }
     };
 
     class StopToken
     {
         friend class StopSource;
 
-        std::shared_ptr<SharedState> shared_state_;
+        template <typename Callback>
+        friend class StopCallback;
+
+        std::shared_ptr<StopState> shared_state_;
 
-        StopToken(std::shared_ptr<SharedState> shared_state)
+        StopToken(std::shared_ptr<StopState> shared_state)
             : shared_state_ {shared_state}
         {
         }
@@ -34,17 +214,17 @@ namespace ext
 
         bool stop_requested() const
         {
-            return shared_state_ ? shared_state_->stop_requested_.load() : false;
+            return shared_state_ ? shared_state_->stop_requested() : false;
         }
     };
 
     class StopSource
     {
-        std::shared_ptr<SharedState> shared_state_;
+        std::shared_ptr<StopState> shared_state_;
 
     public:
         StopSource()
-            : shared_state_ {std::make_shared<SharedState>()}
+            : shared_state_ {std::make_shared<StopState>()}
         {
         }
 
@@ -53,12 +233,138 @@ namespace ext
             return StopToken {shared_state_};
         }
 
-        void request_stop() const
+        bool stop_requested() const
+        {
+            return shared_state_->stop_requested();
+        }
+
+        // invokes all registered callbacks on the calling thread
+        // returns false if stop was already requested
+        bool request_stop() const
+        {
+            return shared_state_->request_stop();
+        }
+    };
+
+    // the same as std::stop_callback:
+    //  - callback is invoked once by request_stop() (or in the constructor if stop was already requested)
+    //  - destructor deregisters the callback or waits until it finishes if it's running on another thread
+    template <typename Callback>
+    class StopCallback : private detail::StopCallbackBase
+    {
+        Callback callback_;
+        std::shared_ptr<StopState> shared_state_;
+
+        static void invoke(detail::StopCallbackBase* base)
+        {
+            static_cast<StopCallback*>(base)->callback_();
+        }
+
+    public:
+        template <typename C, typename = std::enable_if_t<std::is_constructible_v<Callback, C>>>
+        explicit StopCallback(const StopToken& token, C&& callback)
+            : detail::StopCallbackBase {&StopCallback::invoke}
+            , callback_(std::forward<C>(callback))
+        {
+            if (!token.shared_state_)
+                return;
+
+            if (token.shared_state_->try_add_callback(this))
+                shared_state_ = token.shared_state_;
+            else
+                callback_();
+        }
+
+        StopCallback(const StopCallback&) = delete;
+        StopCallback& operator=(const StopCallback&) = delete;
+
+        ~StopCallback()
         {
-            shared_state_->stop_requested_ = true;
+            if (shared_state_)
+                shared_state_->remove_callback(this);
         }
     };
 
+    template <typename Callback>
+    StopCallback(StopToken, Callback) -> StopCallback<Callback>;
+
+    namespace detail
+    {
+        // wakes up a waiter on stop - the waiter holds the mutex while it deregisters the callback,
+        // so a callback on another thread gives up the mutex as soon as the waiter is done
+        template <typename Wait>
+        bool wait_with_wake_up(std::condition_variable& cv, std::unique_lock<std::mutex>& lk, const StopToken& token, Wait wait)
+        {
+            const auto waiting_thread = std::this_thread::get_id();
+            std::mutex* mtx = lk.mutex();
+            std::atomic<bool> is_waiting_done {false};
+
+            StopCallback wake_up {token, [&cv, &is_waiting_done, mtx, waiting_thread] {
+                // on the waiting thread (stop requested before registration) the mutex is already locked
+                if (std::this_thread::get_id() != waiting_thread)
+                {
+                    // no lost wake-up: the waiter checks stop_requested() and starts waiting under the lock
+                    while (!mtx->try_lock())
+                    {
+                        if (is_waiting_done.load(std::memory_order_acquire))
+                            return;
+                        std::this_thread::yield();
+                    }
+                    mtx->unlock();
+                }
+                cv.notify_all();
+            }};
+
+            const bool result = wait();
+            is_waiting_done.store(true, std::memory_order_release);
+
+            return result;
+        }
+    }
+
+    // the same as std::condition_variable_any::wait(lk, stop_token, pred) for std::condition_variable:
+    // waits until pred() is true or stop is requested - returns the result of the last pred() call
+    // (pred() may have side effects, e.g. dequeue an item - it is not called again after it returned true)
+    template <typename Predicate>
+    bool wait(std::condition_variable& cv, std::unique_lock<std::mutex>& lk, const StopToken& token, Predicate pred)
+    {
+        if (pred())
+            return true;
+        if (token.stop_requested())
+            return false;
+
+        return detail::wait_with_wake_up(cv, lk, token, [&] {
+            while (!pred())
+            {
+                if (token.stop_requested())
+                    return false;
+                cv.wait(lk);
+            }
+            return true;
+        });
+    }
+
+    // the same as wait() with a deadline - returns the result of the last pred() call (false on timeout or stop)
+    template <typename Clock, typename Duration, typename Predicate>
+    bool wait_until(std::condition_variable& cv, std::unique_lock<std::mutex>& lk, const StopToken& token,
+        const std::chrono::time_point<Clock, Duration>& deadline, Predicate pred)
+    {
+        if (pred())
+            return true;
+        if (token.stop_requested() || Clock::now() >= deadline)
+            return false;
+
+        return detail::wait_with_wake_up(cv, lk, token, [&] {
+            while (!pred())
+            {
+                if (token.stop_requested())
+                    return false;
+                if (cv.wait_until(lk, deadline) == std::cv_status::timeout)
+                    return pred();
+            }
+            return true;
+        });
+    }
 }
 
-#endif
\ No newline at end of file
+#endif
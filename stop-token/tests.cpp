@@ -2,7 +2,14 @@
 #include "stop_token.hpp"
 
 #include <algorithm>
+#include <functional>
+#include <memory>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
 #include <iostream>
 #include <numeric>
 #include <string>
@@ -58,15 +65,311 @@ TEST_CASE("StopToken - stop requested")
     }
 }
 
-void run(StopToken stop_token)
+TEST_CASE("StopCallback")
+{
+    StopSource source;
+    StopToken st = source.get_token();
+    int counter = 0;
+
+    SECTION("callback is invoked when stop is requested")
+    {
+        StopCallback cb {st, [&] { ++counter; }};
+        REQUIRE(counter == 0);
+
+        REQUIRE(source.request_stop());
+        REQUIRE(counter == 1);
+
+        SECTION("only once")
+        {
+            REQUIRE(source.request_stop() == false);
+            REQUIRE(counter == 1);
+        }
+    }
+
+    SECTION("callback is invoked immediately when stop was already requested")
+    {
+        source.request_stop();
+
+        StopCallback cb {st, [&] { ++counter; }};
+        REQUIRE(counter == 1);
+    }
+
+    SECTION("destroyed callback is not invoked")
+    {
+        {
+            StopCallback cb {st, [&] { ++counter; }};
+        }
+
+        source.request_stop();
+        REQUIRE(counter == 0);
+    }
+
+    SECTION("all registered callbacks are invoked")
+    {
+        StopCallback cb1 {st, [&] { counter += 1; }};
+        StopCallback cb2 {st, [&] { counter += 10; }};
+        StopCallback cb3 {st, [&] { counter += 100; }};
+
+        source.request_stop();
+        REQUIRE(counter == 111);
+    }
+
+    SECTION("callback may destroy itself")
+    {
+        std::optional<StopCallback<std::function<void()>>> cb;
+        cb.emplace(st, [&] { ++counter; cb.reset(); });
+
+        source.request_stop();
+        REQUIRE(counter == 1);
+        REQUIRE_FALSE(cb.has_value());
+    }
+
+    SECTION("default constructed token - callback is never invoked")
+    {
+        StopCallback cb {StopToken {}, [&] { ++counter; }};
+        REQUIRE(counter == 0);
+    }
+}
+
+TEST_CASE("StopCallback - destructor waits for callback running on another thread")
+{
+    StopSource source;
+    std::atomic<bool> callback_started {false};
+    std::atomic<bool> callback_finished {false};
+
+    auto cb = std::make_unique<StopCallback<std::function<void()>>>(source.get_token(), [&] {
+        callback_started = true;
+        std::this_thread::sleep_for(100ms);
+        callback_finished = true;
+    });
+
+    std::thread thd {[&] { source.request_stop(); }};
+
+    while (!callback_started)
+        std::this_thread::yield();
+
+    cb.reset();
+    REQUIRE(callback_finished);
+
+    thd.join();
+}
+
+TEST_CASE("StopCallback - concurrent registration and stop request")
+{
+    for (int i = 0; i < 100; ++i)
+    {
+        StopSource source;
+        std::atomic<int> counter {0};
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&, t] {
+                for (int j = 0; j < 100; ++j)
+                {
+                    StopCallback cb {source.get_token(), [&] { ++counter; }};
+                    if (t == 0 && j == 50)
+                        source.request_stop();
+                }
+            });
+        }
+
+        for (auto& thd : threads)
+            thd.join();
+
+        REQUIRE(source.stop_requested());
+    }
+}
+
+TEST_CASE("wait with StopToken")
+{
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool ready = false;
+    StopSource source;
+
+    SECTION("returns true when predicate is satisfied")
+    {
+        std::thread thd {[&] {
+            std::this_thread::sleep_for(50ms);
+            {
+                std::lock_guard<std::mutex> lk {mtx};
+                ready = true;
+            }
+            cv.notify_one();
+        }};
+
+        std::unique_lock<std::mutex> lk {mtx};
+        REQUIRE(ext::wait(cv, lk, source.get_token(), [&] { return ready; }));
+
+        lk.unlock();
+        thd.join();
+    }
+
+    SECTION("returns false when stop is requested")
+    {
+        std::thread thd {[&] {
+            std::this_thread::sleep_for(50ms);
+            source.request_stop();
+        }};
+
+        std::unique_lock<std::mutex> lk {mtx};
+        REQUIRE(ext::wait(cv, lk, source.get_token(), [&] { return ready; }) == false);
+        REQUIRE(lk.owns_lock());
+
+        lk.unlock();
+        thd.join();
+    }
+
+    SECTION("returns immediately when stop was already requested")
+    {
+        source.request_stop();
+
+        std::unique_lock<std::mutex> lk {mtx};
+        REQUIRE(ext::wait(cv, lk, source.get_token(), [&] { return ready; }) == false);
+    }
+}
+
+// 4 consumers pop 20'000 items with wait_for_item(lk, token, pred) - pred() dequeues an item
+template <typename WaitForItem>
+void pop_all_with_dequeuing_predicate(WaitForItem wait_for_item)
+{
+    const int no_of_items = 20'000;
+    const int no_of_consumers = 4;
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::deque<int> queue;
+    StopSource source;
+
+    std::atomic<int> no_of_popped {0};
+    std::atomic<long long> sum {0};
+
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < no_of_consumers; ++c)
+        consumers.emplace_back([&, token = source.get_token()] {
+            while (!token.stop_requested())
+            {
+                int item;
+                std::unique_lock<std::mutex> lk {mtx};
+                const bool popped = wait_for_item(cv, lk, token, [&] {
+                    if (queue.empty())
+                        return false;
+                    item = queue.front();
+                    queue.pop_front();
+                    return true;
+                });
+
+                if (popped)
+                {
+                    sum += item;
+                    ++no_of_popped;
+                }
+            }
+        });
+
+    for (int i = 1; i <= no_of_items; ++i)
+    {
+        {
+            std::lock_guard<std::mutex> lk {mtx};
+            queue.push_back(i);
+        }
+        cv.notify_one();
+    }
+
+    // a lost item would never be popped
+    const auto deadline = std::chrono::steady_clock::now() + 10s;
+    while (no_of_popped < no_of_items && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(1ms);
+
+    source.request_stop();
+
+    for (auto& thd : consumers)
+        thd.join();
+
+    REQUIRE(no_of_popped == no_of_items);
+    REQUIRE(sum == no_of_items * (no_of_items + 1LL) / 2);
+    REQUIRE(queue.empty());
+}
+
+TEST_CASE("wait with StopToken - many consumers with dequeuing predicate")
+{
+    pop_all_with_dequeuing_predicate([](auto& cv, auto& lk, const StopToken& token, auto pred) {
+        return ext::wait(cv, lk, token, pred);
+    });
+}
+
+TEST_CASE("wait_until with StopToken - many consumers with dequeuing predicate")
+{
+    // short deadlines - like keep-alive of elastic workers
+    pop_all_with_dequeuing_predicate([](auto& cv, auto& lk, const StopToken& token, auto pred) {
+        return ext::wait_until(cv, lk, token, std::chrono::steady_clock::now() + 1ms, pred);
+    });
+}
+
+TEST_CASE("wait_until with StopToken")
 {
-    while (true)
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool ready = false;
+    StopSource source;
+
+    SECTION("returns false after deadline")
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        std::unique_lock<std::mutex> lk {mtx};
+        REQUIRE(ext::wait_until(cv, lk, source.get_token(), start + 50ms, [&] { return ready; }) == false);
+        REQUIRE(lk.owns_lock());
+        REQUIRE(std::chrono::steady_clock::now() - start >= 50ms);
+    }
+
+    SECTION("returns false when stop is requested before deadline")
+    {
+        std::thread thd {[&] {
+            std::this_thread::sleep_for(50ms);
+            source.request_stop();
+        }};
+
+        const auto start = std::chrono::steady_clock::now();
+
+        std::unique_lock<std::mutex> lk {mtx};
+        REQUIRE(ext::wait_until(cv, lk, source.get_token(), start + 10s, [&] { return ready; }) == false);
+        REQUIRE(std::chrono::steady_clock::now() - start < 10s);
+
+        lk.unlock();
+        thd.join();
+    }
+
+    SECTION("returns true when predicate is satisfied before deadline")
     {
-        if (stop_token.stop_requested())
-            break;
+        std::thread thd {[&] {
+            std::this_thread::sleep_for(50ms);
+            {
+                std::lock_guard<std::mutex> lk {mtx};
+                ready = true;
+            }
+            cv.notify_one();
+        }};
+
+        std::unique_lock<std::mutex> lk {mtx};
+        REQUIRE(ext::wait_until(cv, lk, source.get_token(), std::chrono::steady_clock::now() + 10s, [&] { return ready; }));
+
+        lk.unlock();
+        thd.join();
     }
 }
 
+// blocks until stop is requested - no busy waiting
+void run(StopToken stop_token)
+{
+    std::mutex mtx;
+    std::condition_variable cv;
+
+    std::unique_lock<std::mutex> lk {mtx};
+    ext::wait(cv, lk, stop_token, [] { return false; });
+}
+
 TEST_CASE("threads - test1")
 {
     StopSource source;
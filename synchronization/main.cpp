@@ -1,30 +1,44 @@
 #include "joining_thread.hpp"
+#include "seq_locked.hpp"
+#include "sharded_counter.hpp"
+#include "snapshot.hpp"
 
+#include <atomic>
 #include <cassert>
 #include <chrono>
 #include <functional>
 #include <iostream>
+#include <map>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <thread>
 #include <vector>
 
 using namespace std::literals;
 
-template <typename T>
+template <typename T, typename Mutex = std::mutex>
 struct Synchronized
 {
     T value;
-    std::mutex mtx_value;
+    mutable Mutex mtx_value;
 };
 
-template <typename F, typename T>
-void apply(F f, Synchronized<T>& sync_value)
+template <typename F, typename T, typename Mutex>
+void apply(F f, Synchronized<T, Mutex>& sync_value)
 {
     std::lock_guard lk {sync_value.mtx_value};
     f(sync_value.value);
 }
 
+// readers run concurrently - f gets const T&
+template <typename F, typename T>
+void apply_shared(F f, const Synchronized<T, std::shared_mutex>& sync_value)
+{
+    std::shared_lock lk {sync_value.mtx_value};
+    f(sync_value.value);
+}
+
 void run(Synchronized<uint64_t>& counter)
 {
     for (uint64_t i = 0; i < 1'000'000ULL; ++i)
@@ -38,6 +52,219 @@ void run(Synchronized<uint64_t>& counter)
     } // SC ends
 }
 
+// read-mostly data - every route of a version has the same value
+struct Config
+{
+    uint64_t version;
+    std::map<std::string, uint64_t> routes;
+
+    static Config make(uint64_t version)
+    {
+        Config config {version, {}};
+        for (int i = 0; i < 64; ++i)
+            config.routes["route_" + std::to_string(i)] = version;
+        return config;
+    }
+};
+
+template <typename ReadConfig, typename UpdateConfig>
+void run_config_readers(const std::string& name, size_t no_of_readers, uint64_t no_of_reads, ReadConfig read_config, UpdateConfig update_config)
+{
+    std::atomic<size_t> no_of_active_readers {no_of_readers};
+    std::atomic<uint64_t> no_of_inconsistent_reads {0};
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    {
+        std::vector<ext::joining_thread> threads;
+
+        for (size_t r = 0; r < no_of_readers; ++r)
+            threads.emplace_back([&] {
+                uint64_t last_version = 0;
+                uint64_t no_of_inconsistent = 0;
+                for (uint64_t i = 0; i < no_of_reads; ++i)
+                {
+                    read_config([&](const Config& config) {
+                        if (config.routes.at("route_7") != config.version || config.version < last_version)
+                            ++no_of_inconsistent;
+                        last_version = config.version;
+                    });
+                }
+                no_of_inconsistent_reads += no_of_inconsistent;
+                --no_of_active_readers;
+            });
+
+        // rare writer
+        threads.emplace_back([&] {
+            for (uint64_t version = 2; no_of_active_readers > 0; ++version)
+            {
+                update_config(Config::make(version));
+                std::this_thread::sleep_for(1ms);
+            }
+        });
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+
+    std::cout << name << " - " << no_of_readers << " readers: elapsed = "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms"
+              << " (inconsistent reads = " << no_of_inconsistent_reads << ")" << std::endl;
+}
+
+void benchmark_config_reads(uint64_t no_of_reads)
+{
+    std::cout << "\n--------------------------\n";
+    std::cout << "Config reads - Synchronized<T> vs. Snapshot<T>\n";
+
+    for (size_t no_of_readers : {1, 2, 4, 8})
+    {
+        Synchronized<Config> sync_config {Config::make(1), {}};
+        run_config_readers("Synchronized<Config>", no_of_readers, no_of_reads,
+            [&](auto reader) { apply([&](Config& config) { reader(config); }, sync_config); },
+            [&](Config config) { apply([&](Config& current) { current = std::move(config); }, sync_config); });
+
+        ext::Snapshot<Config> snapshot_config {Config::make(1)};
+        run_config_readers("Snapshot<Config>", no_of_readers, no_of_reads,
+            [&](auto reader) { snapshot_config.apply(reader); },
+            [&](Config config) { snapshot_config.store(std::move(config)); });
+    }
+}
+
+template <typename Increment>
+void run_counter(const std::string& name, size_t no_of_threads, uint64_t no_of_increments, Increment increment)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+
+    {
+        std::vector<ext::joining_thread> threads;
+        for (size_t t = 0; t < no_of_threads; ++t)
+            threads.emplace_back([&] {
+                for (uint64_t i = 0; i < no_of_increments; ++i)
+                    increment();
+            });
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+
+    std::cout << name << " - " << no_of_threads << " threads: elapsed = "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms";
+}
+
+void benchmark_counters(uint64_t no_of_increments)
+{
+    std::cout << "\n--------------------------\n";
+    std::cout << "Counter - Synchronized<T> vs. SeqLocked<T> vs. ShardedCounter\n";
+
+    for (size_t no_of_threads : {1, 2, 4, 8})
+    {
+        Synchronized<uint64_t> sync_counter {};
+        run_counter("Synchronized<uint64_t>", no_of_threads, no_of_increments,
+            [&] { apply([](uint64_t& value) { ++value; }, sync_counter); });
+        std::cout << " (counter = " << sync_counter.value << ")" << std::endl;
+
+        ext::SeqLocked<uint64_t> seq_locked_counter {0};
+        run_counter("SeqLocked<uint64_t>", no_of_threads, no_of_increments,
+            [&] { seq_locked_counter.update([](uint64_t& value) { ++value; }); });
+        std::cout << " (counter = " << seq_locked_counter.load() << ")" << std::endl;
+
+        ext::ShardedCounter sharded_counter;
+        run_counter("ShardedCounter", no_of_threads, no_of_increments,
+            [&] { sharded_counter.add(); });
+        std::cout << " (counter = " << sharded_counter.load() << ")" << std::endl;
+    }
+}
+
+// small read-mostly value - all coordinates of a version are equal to it
+struct Position
+{
+    uint64_t version;
+    double x, y, z;
+
+    static Position make(uint64_t version)
+    {
+        const auto coord = static_cast<double>(version);
+        return Position {version, coord, coord, coord};
+    }
+
+    bool is_consistent() const
+    {
+        const auto coord = static_cast<double>(version);
+        return x == coord && y == coord && z == coord;
+    }
+};
+
+template <typename ReadPosition, typename StorePosition>
+void run_position_readers(const std::string& name, size_t no_of_readers, uint64_t no_of_reads, ReadPosition read_position, StorePosition store_position)
+{
+    std::atomic<size_t> no_of_active_readers {no_of_readers};
+    std::atomic<uint64_t> no_of_inconsistent_reads {0};
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    {
+        std::vector<ext::joining_thread> threads;
+
+        for (size_t r = 0; r < no_of_readers; ++r)
+            threads.emplace_back([&] {
+                uint64_t no_of_inconsistent = 0;
+                for (uint64_t i = 0; i < no_of_reads; ++i)
+                {
+                    if (!read_position().is_consistent())
+                        ++no_of_inconsistent;
+                }
+                no_of_inconsistent_reads += no_of_inconsistent;
+                --no_of_active_readers;
+            });
+
+        // rare writer
+        threads.emplace_back([&] {
+            for (uint64_t version = 2; no_of_active_readers > 0; ++version)
+            {
+                store_position(Position::make(version));
+                std::this_thread::sleep_for(100us);
+            }
+        });
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+
+    std::cout << name << " - " << no_of_readers << " readers: elapsed = "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms"
+              << " (inconsistent reads = " << no_of_inconsistent_reads << ")" << std::endl;
+}
+
+void benchmark_position_reads(uint64_t no_of_reads)
+{
+    std::cout << "\n--------------------------\n";
+    std::cout << "Position reads - apply() vs. apply_shared() vs. SeqLocked<T>\n";
+
+    for (size_t no_of_readers : {1, 2, 4, 8})
+    {
+        Synchronized<Position> sync_position {Position::make(1), {}};
+        run_position_readers("Synchronized<Position> + apply", no_of_readers, no_of_reads,
+            [&] {
+                Position result;
+                apply([&](const Position& position) { result = position; }, sync_position);
+                return result;
+            },
+            [&](const Position& position) { apply([&](Position& current) { current = position; }, sync_position); });
+
+        Synchronized<Position, std::shared_mutex> shared_position {Position::make(1), {}};
+        run_position_readers("Synchronized<Position, shared_mutex> + apply_shared", no_of_readers, no_of_reads,
+            [&] {
+                Position result;
+                apply_shared([&](const Position& position) { result = position; }, shared_position);
+                return result;
+            },
+            [&](const Position& position) { apply([&](Position& current) { current = position; }, shared_position); });
+
+        ext::SeqLocked<Position> seq_locked_position {Position::make(1)};
+        run_position_readers("SeqLocked<Position>", no_of_readers, no_of_reads,
+            [&] { return seq_locked_position.load(); },
+            [&](const Position& position) { seq_locked_position.store(position); });
+    }
+}
+
 int main()
 {
     std::cout << "Main thread starts..." << std::endl;
@@ -53,5 +280,9 @@ int main()
 
     std::cout << "Counter: " << counter.value << std::endl;
 
+    benchmark_config_reads(1'000'000);
+    benchmark_counters(1'000'000);
+    benchmark_position_reads(10'000'000);
+
     std::cout << "Main thread ends..." << std::endl;
 }
@@ -0,0 +1,121 @@
+#ifndef SEQ_LOCKED_HPP
+#define SEQ_LOCKED_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace ext
+{
+    // Seqlock - for small, trivially copyable T which is read much more often than written:
+    //  - a reader never writes shared memory - it copies the value and retries if a writer was active
+    //  - the sequence is odd while a writer is active; writers are serialized by a CAS on it
+    //  - the value is kept in relaxed/acquire atomic words, so a torn copy is never a data race
+    template <typename T>
+    class SeqLocked
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "SeqLocked<T> requires trivially copyable T");
+
+        static constexpr size_t no_of_words = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+        using Words = std::array<uint64_t, no_of_words>;
+
+        std::atomic<uint64_t> seq_ {0};
+        std::array<std::atomic<uint64_t>, no_of_words> words_ {};
+
+    public:
+        explicit SeqLocked(const T& value = T {})
+        {
+            store_words(value);
+        }
+
+        SeqLocked(const SeqLocked&) = delete;
+        SeqLocked& operator=(const SeqLocked&) = delete;
+
+        T load() const
+        {
+            while (true)
+            {
+                const uint64_t seq_before = seq_.load(std::memory_order_acquire);
+                if (seq_before & 1)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                Words words;
+                for (size_t i = 0; i < no_of_words; ++i)
+                    words[i] = words_[i].load(std::memory_order_acquire); // the check of seq_ below can't move above
+
+                if (seq_.load(std::memory_order_relaxed) == seq_before)
+                    return from_words(words);
+            }
+        }
+
+        void store(const T& value)
+        {
+            const uint64_t seq = lock();
+            store_words(value);
+            seq_.store(seq + 2, std::memory_order_release);
+        }
+
+        // f(T&) modifies a copy of the current value which is stored afterwards - readers never see a partial update
+        template <typename F>
+        void update(F&& f)
+        {
+            const uint64_t seq = lock();
+
+            T value = load_words();
+            std::forward<F>(f)(value);
+            store_words(value);
+
+            seq_.store(seq + 2, std::memory_order_release);
+        }
+
+    private:
+        // returns the even sequence from before the lock - seq_ is odd afterwards
+        uint64_t lock()
+        {
+            uint64_t seq = seq_.load(std::memory_order_relaxed);
+            while (true)
+            {
+                if ((seq & 1) == 0 && seq_.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire, std::memory_order_relaxed))
+                    return seq;
+
+                std::this_thread::yield();
+                seq = seq_.load(std::memory_order_relaxed);
+            }
+        }
+
+        static T from_words(const Words& words)
+        {
+            T value;
+            std::memcpy(&value, words.data(), sizeof(T));
+            return value;
+        }
+
+        // only the writer which holds the lock
+        T load_words() const
+        {
+            Words words;
+            for (size_t i = 0; i < no_of_words; ++i)
+                words[i] = words_[i].load(std::memory_order_relaxed);
+            return from_words(words);
+        }
+
+        // release stores - a reader which sees a new word also sees the odd sequence
+        void store_words(const T& value)
+        {
+            Words words {};
+            std::memcpy(words.data(), &value, sizeof(T));
+            for (size_t i = 0; i < no_of_words; ++i)
+                words_[i].store(words[i], std::memory_order_release);
+        }
+    };
+}
+
+#endif // SEQ_LOCKED_HPP
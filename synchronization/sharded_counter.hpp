@@ -0,0 +1,75 @@
+#ifndef SHARDED_COUNTER_HPP
+#define SHARDED_COUNTER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace ext
+{
+    // Counter for write-mostly statistics:
+    //  - add() touches only the slot of the current cpu - threads on different cores never share a cache line
+    //  - load() sums all slots - it is not a snapshot while other threads add
+    class ShardedCounter
+    {
+        static constexpr size_t cache_line_size = 64;
+
+        struct alignas(cache_line_size) Slot
+        {
+            std::atomic<uint64_t> value {0};
+        };
+
+        size_t no_of_slots_;
+        std::unique_ptr<Slot[]> slots_;
+
+    public:
+        explicit ShardedCounter(size_t no_of_slots = std::max(1u, std::thread::hardware_concurrency()))
+            : no_of_slots_ {no_of_slots}
+            , slots_ {new Slot[no_of_slots]}
+        {
+        }
+
+        ShardedCounter(const ShardedCounter&) = delete;
+        ShardedCounter& operator=(const ShardedCounter&) = delete;
+
+        void add(uint64_t n = 1)
+        {
+            slots_[this_slot()].value.fetch_add(n, std::memory_order_relaxed);
+        }
+
+        uint64_t load() const
+        {
+            uint64_t sum = 0;
+            for (size_t i = 0; i < no_of_slots_; ++i)
+                sum += slots_[i].value.load(std::memory_order_relaxed);
+            return sum;
+        }
+
+        size_t no_of_slots() const
+        {
+            return no_of_slots_;
+        }
+
+    private:
+        // a migrated thread may share a slot for a while - fetch_add keeps it correct
+        size_t this_slot() const
+        {
+#ifdef __linux__
+            const int cpu = sched_getcpu();
+            if (cpu >= 0)
+                return static_cast<size_t>(cpu) % no_of_slots_;
+#endif
+            thread_local const size_t thread_hash = std::hash<std::thread::id> {}(std::this_thread::get_id());
+            return thread_hash % no_of_slots_;
+        }
+    };
+}
+
+#endif // SHARDED_COUNTER_HPP
@@ -0,0 +1,117 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include "epoch_reclamation.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace ext
+{
+    // RCU-style holder of read-mostly data (configs, routing tables):
+    //  - readers get an immutable version without a lock or a shared refcount - only a pin in Reclaimer
+    //  - writers publish a new version with one atomic store; the old one is retired in Reclaimer
+    //    and freed after the last reader which could see it is done
+    //  - Reclaimer (EpochDomain or HazardPointerDomain) must outlive the snapshot
+    template <typename T, typename Reclaimer = EpochDomain>
+    class Snapshot
+    {
+        std::atomic<const T*> current_;
+        Reclaimer& reclaimer_;
+        std::mutex mtx_writers_;
+
+    public:
+        // keeps the version it points to alive - must not outlive the snapshot's reclaimer
+        class ReadPtr
+        {
+        public:
+            ReadPtr(Reclaimer& reclaimer, const std::atomic<const T*>& src)
+                : guard_ {reclaimer}
+                , ptr_ {guard_.protect(src)}
+            {
+            }
+
+            ReadPtr(const ReadPtr&) = delete;
+            ReadPtr& operator=(const ReadPtr&) = delete;
+
+            const T& operator*() const
+            {
+                return *ptr_;
+            }
+
+            const T* operator->() const
+            {
+                return ptr_;
+            }
+
+            const T* get() const
+            {
+                return ptr_;
+            }
+
+        private:
+            typename Reclaimer::Guard guard_;
+            const T* ptr_;
+        };
+
+        explicit Snapshot(T value, Reclaimer& reclaimer = Reclaimer::global())
+            : current_ {new T(std::move(value))}
+            , reclaimer_ {reclaimer}
+        {
+        }
+
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+
+        // no reader may use the snapshot
+        ~Snapshot()
+        {
+            delete current_.load(std::memory_order_relaxed);
+        }
+
+        ReadPtr read() const
+        {
+            return ReadPtr {reclaimer_, current_};
+        }
+
+        // f(const T&) runs on one consistent version; the result is returned by value -
+        // a reference into the version could dangle once ptr is released
+        template <typename F>
+        auto apply(F&& f) const
+        {
+            ReadPtr ptr = read();
+            return std::forward<F>(f)(*ptr);
+        }
+
+        void store(T value)
+        {
+            std::lock_guard lk {mtx_writers_};
+            publish(new T(std::move(value)));
+        }
+
+        // copy - modify - publish; concurrent writers are serialized, so no update is lost
+        template <typename F>
+        void update(F&& f)
+        {
+            std::lock_guard lk {mtx_writers_};
+
+            auto next = std::make_unique<T>(*current_.load(std::memory_order_relaxed));
+            std::forward<F>(f)(*next);
+            publish(next.release());
+        }
+
+    private:
+        void publish(const T* next)
+        {
+            const T* prev = current_.exchange(next);
+            reclaimer_.retire(const_cast<T*>(prev));
+
+            // writes are rare - frees the versions nobody reads anymore without waiting for the retire threshold
+            reclaimer_.reclaim();
+        }
+    };
+}
+
+#endif // SNAPSHOT_HPP
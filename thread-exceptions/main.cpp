@@ -1,6 +1,9 @@
+#include "result_channel.hpp"
+
 #include <cassert>
 #include <chrono>
 #include <functional>
+#include <future>
 #include <iostream>
 #include <string>
 #include <thread>
@@ -9,9 +12,6 @@
 
 using namespace std::literals;
 
-template <typename T>
-using ThreadResult = std::variant<std::monostate, T, std::exception_ptr>;
-
 void background_work(size_t id, const std::string& text, std::chrono::milliseconds delay, 
                      ThreadResult<char>& result)
 {
@@ -38,16 +38,6 @@ void background_work(size_t id, const std::string& text, std::chrono::millisecon
     std::cout << "bw#" << id << " is finished..." << std::endl;
 }
 
-template <typename... Ts>
-struct overload : Ts...
-{
-    using Ts::operator()...;
-};
-
-// deduction guide
-template <typename... Ts>
-overload(Ts...) -> overload<Ts...>;
-
 //////////////////////////////////
 // How it works
 
@@ -84,6 +74,116 @@ struct Overload : Lambda_86782356782365, Lambda_86782356785345
     using Lambda_86782356785345::operator();
 };
 
+// fan-out of no_of_tasks tasks over no_of_threads threads - every task with id % 100 == 99 fails
+// results come back through one ResultChannel instead of a promise/future pair per task
+void result_channel_demo(size_t no_of_tasks, size_t no_of_threads)
+{
+    const std::string text = "Hello Threads";
+
+    auto task = [&text](size_t id) {
+        return text.at(id % 100 == 99 ? text.size() : id % text.size()); // throws out_of_range
+    };
+
+    ResultChannel<char> results {no_of_tasks};
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < no_of_threads; ++t)
+    {
+        threads.emplace_back([&, t] {
+            for (size_t id = t; id < no_of_tasks; id += no_of_threads)
+                results.set_from(id, [&] { return task(id); });
+        });
+    }
+
+    results.wait();
+
+    size_t no_of_values = 0;
+    results.visit(overload{
+        [](std::monostate) { std::cout << "No value!!!" << std::endl; },
+        [&no_of_values](char) { ++no_of_values; },
+        [](const std::exception_ptr&) {}
+    });
+    std::cout << "ResultChannel: " << no_of_values << " values" << std::endl;
+
+    try
+    {
+        auto values = results.get();
+    }
+    catch (const AggregateException& e)
+    {
+        std::cout << "Caught AggregateException: " << e.what() << std::endl;
+
+        e.visit([](size_t id, std::exception_ptr excpt_ptr) {
+            if (id > 300)
+                return;
+
+            try
+            {
+                std::rethrow_exception(excpt_ptr);
+            }
+            catch (const std::out_of_range& error)
+            {
+                std::cout << "  task#" << id << " - out_of_range: " << error.what() << std::endl;
+            }
+        });
+    }
+
+    for (auto& thd : threads)
+        thd.join();
+}
+
+// the same fan-out: promise/future per task vs one ResultChannel
+void benchmark_result_channel(size_t no_of_tasks, size_t no_of_threads)
+{
+    auto run = [&](const std::string& name, auto set_result, auto collect) {
+        const auto start = std::chrono::high_resolution_clock::now();
+
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < no_of_threads; ++t)
+        {
+            threads.emplace_back([&, t] {
+                for (size_t id = t; id < no_of_tasks; id += no_of_threads)
+                    set_result(id);
+            });
+        }
+
+        const size_t sum = collect();
+
+        const auto end = std::chrono::high_resolution_clock::now();
+
+        for (auto& thd : threads)
+            thd.join();
+
+        std::cout << name << " - sum = " << sum << "; elapsed = "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms" << std::endl;
+    };
+
+    {
+        std::vector<std::promise<size_t>> promises(no_of_tasks);
+        std::vector<std::future<size_t>> futures;
+        for (auto& p : promises)
+            futures.push_back(p.get_future());
+
+        run("promise/future per task", [&](size_t id) { promises[id].set_value(id); }, [&] {
+            size_t sum = 0;
+            for (auto& f : futures)
+                sum += f.get();
+            return sum;
+        });
+    }
+
+    {
+        ResultChannel<size_t> results {no_of_tasks};
+
+        run("ResultChannel", [&](size_t id) { results.set_value(id, id); }, [&] {
+            size_t sum = 0;
+            for (size_t value : results.get())
+                sum += value;
+            return sum;
+        });
+    }
+}
+
 int main()
 {
     auto l = [](int x) { return 42 * x; };
@@ -145,5 +245,8 @@ int main()
     //     std::cout << "Value: " << value << std::endl;        
     // }
 
+    result_channel_demo(1'000, 4);
+    benchmark_result_channel(1'000'000, 4);
+
     std::cout << "Main thread ends..." << std::endl;
 }
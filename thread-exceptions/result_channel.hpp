@@ -0,0 +1,208 @@
+#ifndef RESULT_CHANNEL_HPP
+#define RESULT_CHANNEL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+template <typename T>
+using ThreadResult = std::variant<std::monostate, T, std::exception_ptr>;
+
+template <typename... Ts>
+struct overload : Ts...
+{
+    using Ts::operator()...;
+};
+
+// deduction guide
+template <typename... Ts>
+overload(Ts...) -> overload<Ts...>;
+
+// all exceptions thrown by a group of tasks - with the indexes of the tasks
+class AggregateException : public std::exception
+{
+public:
+    using Entry = std::pair<size_t, std::exception_ptr>;
+
+    explicit AggregateException(std::vector<Entry> exceptions, size_t no_of_tasks)
+        : exceptions_ {std::move(exceptions)}
+        , message_ {std::to_string(exceptions_.size()) + " of " + std::to_string(no_of_tasks) + " tasks failed"}
+    {
+    }
+
+    const char* what() const noexcept override
+    {
+        return message_.c_str();
+    }
+
+    size_t size() const noexcept
+    {
+        return exceptions_.size();
+    }
+
+    const std::vector<Entry>& exceptions() const noexcept
+    {
+        return exceptions_;
+    }
+
+    // visitor(index, exception_ptr) for every failed task
+    template <typename Visitor>
+    void visit(Visitor&& visitor) const
+    {
+        for (const auto& [index, exception] : exceptions_)
+            visitor(index, exception);
+    }
+
+private:
+    std::vector<Entry> exceptions_;
+    std::string message_;
+};
+
+// Results of a fan-out of size tasks - one ThreadResult slot per task instead of a future (and a shared state) per task:
+//  - slots are stored contiguously, each in its own cache line - no false sharing between writers
+//  - every slot is written by one task only, without locks; a writer publishes its slot by counting down
+//    the number of pending tasks (release) - the last one wakes up wait()
+//  - reset() makes the channel reusable for the next fan-out of the same size
+template <typename T>
+class ResultChannel
+{
+public:
+    explicit ResultChannel(size_t size)
+        : slots_ {std::make_unique<Slot[]>(size)}
+        , size_ {size}
+        , no_of_pending_ {size}
+    {
+    }
+
+    ResultChannel(const ResultChannel&) = delete;
+    ResultChannel& operator=(const ResultChannel&) = delete;
+
+    size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    template <typename U>
+    void set_value(size_t index, U&& value)
+    {
+        slots_[index].result.template emplace<1>(std::forward<U>(value));
+        arrive();
+    }
+
+    void set_exception(size_t index, std::exception_ptr exception)
+    {
+        slots_[index].result.template emplace<2>(std::move(exception));
+        arrive();
+    }
+
+    // stores the result of f() or the exception thrown by it
+    template <typename Callable>
+    void set_from(size_t index, Callable&& f) noexcept
+    {
+        try
+        {
+            set_value(index, std::forward<Callable>(f)());
+        }
+        catch (...)
+        {
+            set_exception(index, std::current_exception());
+        }
+    }
+
+    bool is_ready() const noexcept
+    {
+        return no_of_pending_.load(std::memory_order_acquire) == 0;
+    }
+
+    // blocks until every slot is set - the channel may be destroyed only after wait()
+    // (the last writer still holds the mutex when is_ready() becomes true)
+    void wait() const
+    {
+        std::unique_lock<std::mutex> lk {mtx_};
+        cv_ready_.wait(lk, [this] { return is_ready(); });
+    }
+
+    // slots may be read only after wait()
+    const ThreadResult<T>& operator[](size_t index) const noexcept
+    {
+        return slots_[index].result;
+    }
+
+    // std::visit(visitor, slot) for every slot - e.g. with overload {...}
+    template <typename Visitor>
+    void visit(Visitor&& visitor) const
+    {
+        for (size_t i = 0; i < size_; ++i)
+            std::visit(visitor, slots_[i].result);
+    }
+
+    AggregateException exceptions() const
+    {
+        std::vector<AggregateException::Entry> exceptions;
+        for (size_t i = 0; i < size_; ++i)
+        {
+            if (auto exception = std::get_if<std::exception_ptr>(&slots_[i].result))
+                exceptions.emplace_back(i, *exception);
+        }
+        return AggregateException {std::move(exceptions), size_};
+    }
+
+    // waits for all tasks; throws AggregateException if any of them failed
+    std::vector<T> get() const
+    {
+        wait();
+
+        if (auto aggregate = exceptions(); aggregate.size() > 0)
+            throw aggregate;
+
+        std::vector<T> values;
+        values.reserve(size_);
+        for (size_t i = 0; i < size_; ++i)
+            values.push_back(std::get<T>(slots_[i].result));
+        return values;
+    }
+
+    // must not be called while tasks are writing
+    void reset()
+    {
+        for (size_t i = 0; i < size_; ++i)
+            slots_[i].result = std::monostate {};
+        no_of_pending_.store(size_, std::memory_order_relaxed);
+    }
+
+private:
+    struct alignas(64) Slot
+    {
+        ThreadResult<T> result;
+    };
+
+    void arrive()
+    {
+        size_t no_of_pending = no_of_pending_.load(std::memory_order_relaxed);
+        while (no_of_pending > 1)
+        {
+            if (no_of_pending_.compare_exchange_weak(no_of_pending, no_of_pending - 1, std::memory_order_acq_rel))
+                return;
+        }
+
+        // the last writer counts down under the mutex - wait() can't return before it is released
+        std::lock_guard<std::mutex> lk {mtx_};
+        no_of_pending_.fetch_sub(1, std::memory_order_acq_rel);
+        cv_ready_.notify_all();
+    }
+
+    std::unique_ptr<Slot[]> slots_;
+    const size_t size_;
+    std::atomic<size_t> no_of_pending_;
+    mutable std::mutex mtx_;
+    mutable std::condition_variable cv_ready_;
+};
+
+#endif // RESULT_CHANNEL_HPP
@@ -0,0 +1,321 @@
+#ifndef AFFINITY_HPP
+#define AFFINITY_HPP
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ext
+{
+    enum class AffinityPolicy
+    {
+        none,    // threads are placed by the OS
+        compact, // worker i -> i-th cpu: SMT siblings of a core, then cores of a node, then the next node
+        scatter, // round robin over nodes, one worker per core before the SMT siblings are used
+        per_node // workers split evenly between nodes - each is pinned to all cpus of its node
+    };
+
+    struct CpuInfo
+    {
+        unsigned cpu;
+        unsigned core;
+        unsigned package;
+        unsigned node; // dense index: 0 ... no_of_nodes() - 1
+    };
+
+    struct WorkerPlacement
+    {
+        std::vector<unsigned> cpus; // empty - not pinned
+        unsigned node;
+    };
+
+    namespace detail
+    {
+        // "0-3,8,10-11" -> {0, 1, 2, 3, 8, 10, 11}
+        inline std::vector<unsigned> parse_cpu_list(const std::string& list)
+        {
+            std::vector<unsigned> cpus;
+
+            size_t pos = 0;
+            while (pos < list.size())
+            {
+                size_t end = list.find(',', pos);
+                if (end == std::string::npos)
+                    end = list.size();
+
+                const std::string range = list.substr(pos, end - pos);
+                const size_t dash = range.find('-');
+                try
+                {
+                    const unsigned first = std::stoul(range.substr(0, dash));
+                    const unsigned last = dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+                    for (unsigned cpu = first; cpu <= last; ++cpu)
+                        cpus.push_back(cpu);
+                }
+                catch (const std::exception&) // empty or malformed entry
+                {
+                }
+
+                pos = end + 1;
+            }
+
+            return cpus;
+        }
+
+        inline bool read_first_line(const std::string& path, std::string& line)
+        {
+            std::ifstream file {path};
+            return static_cast<bool>(std::getline(file, line));
+        }
+
+        inline unsigned read_number(const std::string& path, unsigned default_value)
+        {
+            std::string line;
+            if (!read_first_line(path, line))
+                return default_value;
+
+            try
+            {
+                return static_cast<unsigned>(std::stol(line)); // physical_package_id may be -1
+            }
+            catch (const std::exception&)
+            {
+                return default_value;
+            }
+        }
+    }
+
+    // cpus the process may run on with their core/package/NUMA node (read from /sys)
+    // without /sys: hardware_concurrency() cpus in a single node
+    class CpuTopology
+    {
+    public:
+        static const CpuTopology& system()
+        {
+            static const CpuTopology topology = detect();
+            return topology;
+        }
+
+        // sys_root - another root than /sys/devices/system/ (e.g. a copy of the topology of another machine)
+        // only_allowed_cpus - drop cpus outside of the affinity mask of the process (taskset, cgroups)
+        static CpuTopology detect(const std::string& sys_root = "/sys/devices/system/", bool only_allowed_cpus = true)
+        {
+            const std::string sys_cpu = sys_root + "cpu/";
+            const std::string sys_node = sys_root + "node/";
+
+            CpuTopology topology;
+
+            std::string line;
+            std::vector<unsigned> cpus = detail::read_first_line(sys_cpu + "online", line) ? detail::parse_cpu_list(line) : std::vector<unsigned> {};
+            if (cpus.empty())
+            {
+                for (unsigned cpu = 0; cpu < std::max(std::thread::hardware_concurrency(), 1u); ++cpu)
+                    cpus.push_back(cpu);
+            }
+
+#ifdef __linux__
+            cpu_set_t allowed;
+            CPU_ZERO(&allowed);
+            if (only_allowed_cpus && sched_getaffinity(0, sizeof(allowed), &allowed) == 0)
+            {
+                std::vector<unsigned> allowed_cpus;
+                std::copy_if(cpus.begin(), cpus.end(), std::back_inserter(allowed_cpus),
+                    [&allowed](unsigned cpu) { return cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed); });
+                if (!allowed_cpus.empty())
+                    cpus = std::move(allowed_cpus);
+            }
+#endif
+
+            // node ids may have gaps - they are renumbered
+            std::map<unsigned, unsigned> node_of_cpu;
+            if (detail::read_first_line(sys_node + "online", line))
+            {
+                unsigned dense_index = 0;
+                for (unsigned node : detail::parse_cpu_list(line))
+                {
+                    std::string cpu_list;
+                    if (!detail::read_first_line(sys_node + "node" + std::to_string(node) + "/cpulist", cpu_list))
+                        continue;
+
+                    const auto node_cpus = detail::parse_cpu_list(cpu_list);
+                    if (std::none_of(node_cpus.begin(), node_cpus.end(), [&cpus](unsigned cpu) {
+                            return std::find(cpus.begin(), cpus.end(), cpu) != cpus.end();
+                        }))
+                        continue; // memory-only node or no allowed cpu
+
+                    for (unsigned cpu : node_cpus)
+                        node_of_cpu[cpu] = dense_index;
+                    ++dense_index;
+                }
+            }
+
+            for (unsigned cpu : cpus)
+            {
+                const std::string topology_dir = sys_cpu + "cpu" + std::to_string(cpu) + "/topology/";
+                const auto node = node_of_cpu.find(cpu);
+
+                topology.cpus_.push_back(CpuInfo {cpu, detail::read_number(topology_dir + "core_id", cpu),
+                    detail::read_number(topology_dir + "physical_package_id", 0), node == node_of_cpu.end() ? 0 : node->second});
+            }
+
+            std::sort(topology.cpus_.begin(), topology.cpus_.end(), [](const CpuInfo& a, const CpuInfo& b) {
+                return std::tie(a.node, a.package, a.core, a.cpu) < std::tie(b.node, b.package, b.core, b.cpu);
+            });
+
+            for (const auto& info : topology.cpus_)
+            {
+                topology.no_of_nodes_ = std::max<size_t>(topology.no_of_nodes_, info.node + 1);
+                if (topology.node_of_cpu_.size() <= info.cpu)
+                    topology.node_of_cpu_.resize(info.cpu + 1, 0);
+                topology.node_of_cpu_[info.cpu] = info.node;
+            }
+
+            return topology;
+        }
+
+        // ordered by node, package, core and cpu number
+        const std::vector<CpuInfo>& cpus() const
+        {
+            return cpus_;
+        }
+
+        size_t no_of_nodes() const
+        {
+            return no_of_nodes_;
+        }
+
+        std::vector<unsigned> cpus_of_node(unsigned node) const
+        {
+            std::vector<unsigned> node_cpus;
+            for (const auto& info : cpus_)
+            {
+                if (info.node == node)
+                    node_cpus.push_back(info.cpu);
+            }
+            return node_cpus;
+        }
+
+        // node of the cpu the calling thread is running on right now (0 if unknown)
+        unsigned current_node() const
+        {
+#ifdef __linux__
+            const int cpu = sched_getcpu();
+            if (cpu >= 0 && static_cast<size_t>(cpu) < node_of_cpu_.size())
+                return node_of_cpu_[cpu];
+#endif
+            return 0;
+        }
+
+        // placement of no_of_workers threads - more workers than cpus wrap around
+        std::vector<WorkerPlacement> place_workers(AffinityPolicy policy, size_t no_of_workers) const
+        {
+            std::vector<WorkerPlacement> placements;
+            placements.reserve(no_of_workers);
+
+            if (policy == AffinityPolicy::none || cpus_.empty())
+            {
+                placements.resize(no_of_workers, WorkerPlacement {{}, 0});
+                return placements;
+            }
+
+            if (policy == AffinityPolicy::compact)
+            {
+                for (size_t i = 0; i < no_of_workers; ++i)
+                {
+                    const auto& info = cpus_[i % cpus_.size()];
+                    placements.push_back(WorkerPlacement {{info.cpu}, info.node});
+                }
+                return placements;
+            }
+
+            if (policy == AffinityPolicy::per_node)
+            {
+                for (size_t i = 0; i < no_of_workers; ++i)
+                {
+                    const auto node = static_cast<unsigned>(i % no_of_nodes_);
+                    placements.push_back(WorkerPlacement {cpus_of_node(node), node});
+                }
+                return placements;
+            }
+
+            // scatter: per node - first SMT thread of every core, then the second ones, ...
+            std::vector<std::vector<CpuInfo>> node_cpus(no_of_nodes_);
+            for (unsigned node = 0; node < no_of_nodes_; ++node)
+            {
+                std::map<std::pair<unsigned, unsigned>, unsigned> sibling_count;
+                std::vector<std::pair<unsigned, CpuInfo>> ranked;
+                for (const auto& info : cpus_)
+                {
+                    if (info.node == node)
+                        ranked.emplace_back(sibling_count[{info.package, info.core}]++, info);
+                }
+
+                std::stable_sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+                for (const auto& [rank, info] : ranked)
+                    node_cpus[node].push_back(info);
+            }
+
+            for (size_t i = 0; i < no_of_workers; ++i)
+            {
+                const auto& cpus = node_cpus[i % no_of_nodes_];
+                const auto& info = cpus[(i / no_of_nodes_) % cpus.size()];
+                placements.push_back(WorkerPlacement {{info.cpu}, info.node});
+            }
+            return placements;
+        }
+
+    private:
+        std::vector<CpuInfo> cpus_;
+        std::vector<unsigned> node_of_cpu_;
+        size_t no_of_nodes_ {1};
+    };
+
+    // pins the calling thread to the cpus (Linux only - returns false elsewhere or when the cpus are not allowed)
+    inline bool pin_this_thread(const std::vector<unsigned>& cpus)
+    {
+#ifdef __linux__
+        if (cpus.empty())
+            return false;
+
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        for (unsigned cpu : cpus)
+        {
+            if (cpu < CPU_SETSIZE)
+                CPU_SET(cpu, &cpu_set);
+        }
+
+        return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+#else
+        (void)cpus;
+        return false;
+#endif
+    }
+
+    inline const char* to_string(AffinityPolicy policy)
+    {
+        switch (policy)
+        {
+        case AffinityPolicy::compact:
+            return "compact";
+        case AffinityPolicy::scatter:
+            return "scatter";
+        case AffinityPolicy::per_node:
+            return "per_node";
+        default:
+            return "none";
+        }
+    }
+}
+
+#endif // AFFINITY_HPP
@@ -0,0 +1,42 @@
+#include "allocation_counter.hpp"
+
+#include <cstdlib>
+#include <new>
+
+std::atomic<size_t> no_of_allocations {0};
+
+// all forms go through the same pair of functions - the sized & array ones only forward
+void* operator new(std::size_t size)
+{
+    no_of_allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+
+    throw std::bad_alloc {};
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    ::operator delete(ptr);
+}
+
+void* operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    ::operator delete(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    ::operator delete(ptr);
+}
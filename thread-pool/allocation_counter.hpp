@@ -0,0 +1,12 @@
+#ifndef ALLOCATION_COUNTER_HPP
+#define ALLOCATION_COUNTER_HPP
+
+#include <atomic>
+#include <cstddef>
+
+// counts heap allocations made by the whole program (used by benchmark_allocations())
+//  - operator new & delete are replaced in allocation_counter.cpp - in a separate translation unit
+//    they are never inlined into callers, so the compiler doesn't pair malloc/free with new/delete
+extern std::atomic<size_t> no_of_allocations;
+
+#endif // ALLOCATION_COUNTER_HPP
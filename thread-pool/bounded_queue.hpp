@@ -0,0 +1,300 @@
+#ifndef BOUNDED_QUEUE_HPP
+#define BOUNDED_QUEUE_HPP
+
+#include "stop_token.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Lock-free bounded MPMC queue (ring buffer by D. Vyukov)
+//  - every slot has a sequence number which tells if the slot is ready for push or for pop
+//  - producers claim slots with CAS on tail_, consumers with CAS on head_
+//  - head_ and tail_ live on separate cache lines
+// Blocking push()/pop() spin for a while and then park on a condition variable.
+// The mutex is touched only when some thread really has to sleep.
+template <typename T, size_t Capacity>
+class BoundedQueue
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2");
+
+    static constexpr size_t cache_line_size = 64;
+    static constexpr size_t mask_ = Capacity - 1;
+    static constexpr int spin_count_ = 64;
+
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        T item;
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    alignas(cache_line_size) std::atomic<size_t> tail_ {0};
+    alignas(cache_line_size) std::atomic<size_t> head_ {0};
+
+    alignas(cache_line_size) std::atomic<int> waiting_consumers_ {0};
+    std::atomic<int> waiting_producers_ {0};
+    std::mutex mtx_wait_;
+    std::condition_variable cv_not_empty_;
+    std::condition_variable cv_not_full_;
+
+public:
+    BoundedQueue()
+        : slots_ {new Slot[Capacity]}
+    {
+        for (size_t i = 0; i < Capacity; ++i)
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    static constexpr size_t capacity()
+    {
+        return Capacity;
+    }
+
+    // approximate when other threads push or pop at the same time
+    size_t size() const
+    {
+        const size_t head = head_.load(std::memory_order_acquire);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    // non-blocking operation - returns false when queue is full
+    bool try_push(const T& item)
+    {
+        return try_push_item(item);
+    }
+
+    bool try_push(T&& item)
+    {
+        return try_push_item(std::move(item));
+    }
+
+    // blocking operation - waits if queue is full
+    void push(const T& item)
+    {
+        push_item(item);
+    }
+
+    void push(T&& item)
+    {
+        push_item(std::move(item));
+    }
+
+    void push(std::initializer_list<T> items)
+    {
+        for (const auto& item : items)
+            push_item(item);
+    }
+
+    template <typename InputIt>
+    void push(InputIt first, InputIt last)
+    {
+        for (; first != last; ++first)
+            push_item(*first);
+    }
+
+    // non-blocking operation - returns false when queue is empty
+    bool try_pop(T& item)
+    {
+        if (!dequeue(item))
+            return false;
+
+        notify(waiting_producers_, cv_not_full_);
+        return true;
+    }
+
+    // blocking operation - waits if queue is empty
+    void pop(T& item)
+    {
+        for (int i = 0; i < spin_count_; ++i)
+        {
+            if (try_pop(item))
+                return;
+            std::this_thread::yield();
+        }
+
+        {
+            std::unique_lock<std::mutex> lk {mtx_wait_};
+            waiting_consumers_.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            cv_not_empty_.wait(lk, [&] { return dequeue(item); });
+            waiting_consumers_.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        notify(waiting_producers_, cv_not_full_);
+    }
+
+    // blocking operation - waits if queue is empty
+    // returns false when stop is requested before an item is available
+    bool pop(T& item, const ext::StopToken& token)
+    {
+        for (int i = 0; i < spin_count_; ++i)
+        {
+            if (try_pop(item))
+                return true;
+            if (token.stop_requested())
+                return false;
+            std::this_thread::yield();
+        }
+
+        {
+            std::unique_lock<std::mutex> lk {mtx_wait_};
+            waiting_consumers_.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const bool popped = ext::wait(cv_not_empty_, lk, token, [&] { return dequeue(item); });
+            waiting_consumers_.fetch_sub(1, std::memory_order_relaxed);
+
+            if (!popped)
+                return false;
+        }
+
+        notify(waiting_producers_, cv_not_full_);
+        return true;
+    }
+
+    // returns false when the queue stays empty for timeout or stop is requested
+    template <typename Rep, typename Period>
+    bool pop_for(T& item, const ext::StopToken& token, const std::chrono::duration<Rep, Period>& timeout)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+        for (int i = 0; i < spin_count_; ++i)
+        {
+            if (try_pop(item))
+                return true;
+            if (token.stop_requested())
+                return false;
+            std::this_thread::yield();
+        }
+
+        {
+            std::unique_lock<std::mutex> lk {mtx_wait_};
+            waiting_consumers_.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const bool popped = ext::wait_until(cv_not_empty_, lk, token, deadline, [&] { return dequeue(item); });
+            waiting_consumers_.fetch_sub(1, std::memory_order_relaxed);
+
+            if (!popped)
+                return false;
+        }
+
+        notify(waiting_producers_, cv_not_full_);
+        return true;
+    }
+
+private:
+    template <typename U>
+    bool enqueue(U&& item)
+    {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            Slot& slot = slots_[pos & mask_];
+            const size_t seq = slot.sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+            if (diff == 0)
+            {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    slot.item = std::forward<U>(item);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+                return false; // full
+            else
+                pos = tail_.load(std::memory_order_relaxed);
+        }
+    }
+
+    bool dequeue(T& item)
+    {
+        size_t pos = head_.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            Slot& slot = slots_[pos & mask_];
+            const size_t seq = slot.sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+
+            if (diff == 0)
+            {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    item = std::move(slot.item);
+                    slot.sequence.store(pos + Capacity, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+                return false; // empty
+            else
+                pos = head_.load(std::memory_order_relaxed);
+        }
+    }
+
+    template <typename U>
+    bool try_push_item(U&& item)
+    {
+        if (!enqueue(std::forward<U>(item)))
+            return false;
+
+        notify(waiting_consumers_, cv_not_empty_);
+        return true;
+    }
+
+    template <typename U>
+    void push_item(U&& item)
+    {
+        for (int i = 0; i < spin_count_; ++i)
+        {
+            if (try_push_item(std::forward<U>(item)))
+                return;
+            std::this_thread::yield();
+        }
+
+        {
+            std::unique_lock<std::mutex> lk {mtx_wait_};
+            waiting_producers_.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            cv_not_full_.wait(lk, [&] { return enqueue(std::forward<U>(item)); });
+            waiting_producers_.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        notify(waiting_consumers_, cv_not_empty_);
+    }
+
+    // pairs with the fence in pop()/push_item(): either the sleeper sees the new state of the slot
+    // or we see the sleeper registered in the waiting counter
+    void notify(std::atomic<int>& waiting, std::condition_variable& cv)
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiting.load(std::memory_order_relaxed) > 0)
+        {
+            {
+                std::lock_guard<std::mutex> lk {mtx_wait_};
+            }
+            cv.notify_one();
+        }
+    }
+};
+
+#endif // BOUNDED_QUEUE_HPP
@@ -0,0 +1,537 @@
+#ifndef FUTURE_HPP
+#define FUTURE_HPP
+
+#include "task.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace ext
+{
+    // Shared state of Promise/Future - a single allocation with an intrusive ref counter
+    // (std::promise allocates the state and the result separately and manages them with shared_ptr)
+    // One continuation may be attached - it runs on the thread which makes the state ready
+    // (or inline on the attaching thread if the state is already ready)
+    template <typename T>
+    class SharedState
+    {
+    public:
+        using ValueType = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+        void add_ref() noexcept
+        {
+            ref_count_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void release() noexcept
+        {
+            if (ref_count_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                delete this;
+        }
+
+        bool is_ready() const noexcept
+        {
+            return ready_.load(std::memory_order_acquire);
+        }
+
+        template <typename... Args>
+        void set_value(Args&&... args)
+        {
+            Task continuation;
+            {
+                std::lock_guard<std::mutex> lk {mtx_};
+                throw_if_satisfied();
+                result_.template emplace<1>(std::forward<Args>(args)...);
+                ready_.store(true, std::memory_order_release);
+                continuation = std::move(continuation_);
+            }
+            cv_ready_.notify_all();
+
+            if (continuation)
+                continuation();
+        }
+
+        void set_exception(std::exception_ptr e)
+        {
+            Task continuation;
+            {
+                std::lock_guard<std::mutex> lk {mtx_};
+                throw_if_satisfied();
+                result_.template emplace<2>(std::move(e));
+                ready_.store(true, std::memory_order_release);
+                continuation = std::move(continuation_);
+            }
+            cv_ready_.notify_all();
+
+            if (continuation)
+                continuation();
+        }
+
+        // replaces the previous continuation
+        template <typename Continuation>
+        void set_continuation(Continuation&& continuation)
+        {
+            if (!is_ready())
+            {
+                std::lock_guard<std::mutex> lk {mtx_};
+                if (!is_ready())
+                {
+                    continuation_ = Task {std::forward<Continuation>(continuation)};
+                    return;
+                }
+            }
+
+            continuation();
+        }
+
+        void wait()
+        {
+            if (is_ready())
+                return;
+
+            std::unique_lock<std::mutex> lk {mtx_};
+            cv_ready_.wait(lk, [this] { return is_ready(); });
+        }
+
+        template <typename Rep, typename Period>
+        std::future_status wait_for(const std::chrono::duration<Rep, Period>& timeout)
+        {
+            if (is_ready())
+                return std::future_status::ready;
+
+            std::unique_lock<std::mutex> lk {mtx_};
+            return cv_ready_.wait_for(lk, timeout, [this] { return is_ready(); })
+                ? std::future_status::ready
+                : std::future_status::timeout;
+        }
+
+        ValueType get()
+        {
+            wait();
+
+            if (result_.index() == 2)
+                std::rethrow_exception(std::get<2>(result_));
+
+            return std::move(std::get<1>(result_));
+        }
+
+    private:
+        void throw_if_satisfied()
+        {
+            if (result_.index() != 0)
+                throw std::future_error(std::future_errc::promise_already_satisfied);
+        }
+
+        std::atomic<int> ref_count_ {1};
+        std::atomic<bool> ready_ {false};
+        std::mutex mtx_;
+        std::condition_variable cv_ready_;
+        std::variant<std::monostate, ValueType, std::exception_ptr> result_;
+        Task continuation_;
+    };
+
+    // stored in the future of a task which has been cancelled before it started
+    class OperationCancelled : public std::runtime_error
+    {
+    public:
+        OperationCancelled()
+            : std::runtime_error {"Operation cancelled"}
+        {
+        }
+    };
+
+    template <typename T>
+    class Promise;
+
+    template <typename T>
+    class Future;
+
+    template <typename T>
+    struct WhenAnyResult
+    {
+        size_t index;
+        Future<T> future;
+    };
+
+    // the same interface as std::future<T> plus continuations (like std::experimental::future):
+    //  - then(f) - f(ready_future) runs on the thread which fulfils the promise (inline if already ready)
+    //  - then(executor, f) - f(ready_future) is submitted to the executor (e.g. ThreadPool) when ready
+    //  - the future is not valid after then() - the continuation owns it
+    template <typename T>
+    class Future
+    {
+        friend class Promise<T>;
+
+        SharedState<T>* state_ {};
+
+        explicit Future(SharedState<T>* state)
+            : state_ {state}
+        {
+            state_->add_ref();
+        }
+
+    public:
+        Future() = default;
+
+        Future(const Future&) = delete;
+        Future& operator=(const Future&) = delete;
+
+        Future(Future&& other) noexcept
+            : state_ {std::exchange(other.state_, nullptr)}
+        {
+        }
+
+        Future& operator=(Future&& other) noexcept
+        {
+            if (this != &other)
+            {
+                if (state_)
+                    state_->release();
+                state_ = std::exchange(other.state_, nullptr);
+            }
+            return *this;
+        }
+
+        ~Future()
+        {
+            if (state_)
+                state_->release();
+        }
+
+        bool valid() const noexcept
+        {
+            return state_ != nullptr;
+        }
+
+        bool is_ready() const
+        {
+            throw_if_invalid();
+            return state_->is_ready();
+        }
+
+        void wait() const
+        {
+            throw_if_invalid();
+            state_->wait();
+        }
+
+        template <typename Rep, typename Period>
+        std::future_status wait_for(const std::chrono::duration<Rep, Period>& timeout) const
+        {
+            throw_if_invalid();
+            return state_->wait_for(timeout);
+        }
+
+        T get()
+        {
+            throw_if_invalid();
+
+            Future released = std::move(*this); // future is not valid after get()
+
+            if constexpr (std::is_void_v<T>)
+                released.state_->get();
+            else
+                return released.state_->get();
+        }
+
+        template <typename Continuation>
+        auto then(Continuation&& continuation)
+        {
+            using ResultT = std::invoke_result_t<std::decay_t<Continuation>&, Future>;
+
+            Promise<ResultT> promise;
+            Future<ResultT> result = promise.get_future();
+
+            on_ready([promise = std::move(promise), continuation = std::forward<Continuation>(continuation)](Future ready) mutable {
+                promise.set_from([&]() -> ResultT { return std::invoke(continuation, std::move(ready)); });
+            });
+
+            return result;
+        }
+
+        // executor has to provide submit(callable) which returns Future
+        template <typename Executor, typename Continuation>
+        auto then(Executor& executor, Continuation&& continuation)
+        {
+            using ResultT = std::invoke_result_t<std::decay_t<Continuation>&, Future>;
+
+            Promise<ResultT> promise;
+            Future<ResultT> result = promise.get_future();
+
+            on_ready([&executor, promise = std::move(promise), continuation = std::forward<Continuation>(continuation)](Future ready) mutable {
+                Future<ResultT> scheduled = executor.submit([continuation = std::move(continuation), ready = std::move(ready)]() mutable -> ResultT {
+                    return std::invoke(continuation, std::move(ready));
+                });
+
+                // result (or OperationCancelled) of the scheduled task is moved to the returned future
+                scheduled.on_ready([promise = std::move(promise)](Future<ResultT> done) mutable {
+                    promise.set_from([&]() -> ResultT { return done.get(); });
+                });
+            });
+
+            return result;
+        }
+
+        // low-level building block of then()/when_all()/when_any():
+        // callback(ready_future) is invoked once - the future is not valid after the call
+        template <typename Callback>
+        void on_ready(Callback&& callback)
+        {
+            throw_if_invalid();
+
+            SharedState<T>* state = state_;
+            state->set_continuation([callback = std::forward<Callback>(callback), ready = std::move(*this)]() mutable {
+                callback(std::move(ready));
+            });
+        }
+
+    private:
+        void throw_if_invalid() const
+        {
+            if (!state_)
+                throw std::future_error(std::future_errc::no_state);
+        }
+    };
+
+    // the same interface as std::promise<T>
+    template <typename T>
+    class Promise
+    {
+        SharedState<T>* state_ {new SharedState<T>()};
+        bool future_retrieved_ {false};
+
+    public:
+        Promise() = default;
+
+        Promise(const Promise&) = delete;
+        Promise& operator=(const Promise&) = delete;
+
+        Promise(Promise&& other) noexcept
+            : state_ {std::exchange(other.state_, nullptr)}
+            , future_retrieved_ {other.future_retrieved_}
+        {
+        }
+
+        Promise& operator=(Promise&& other) noexcept
+        {
+            if (this != &other)
+            {
+                abandon();
+                state_ = std::exchange(other.state_, nullptr);
+                future_retrieved_ = other.future_retrieved_;
+            }
+            return *this;
+        }
+
+        ~Promise()
+        {
+            abandon();
+        }
+
+        Future<T> get_future()
+        {
+            if (!state_)
+                throw std::future_error(std::future_errc::no_state);
+            if (std::exchange(future_retrieved_, true))
+                throw std::future_error(std::future_errc::future_already_retrieved);
+
+            return Future<T> {state_};
+        }
+
+        template <typename... Args>
+        void set_value(Args&&... args)
+        {
+            if (!state_)
+                throw std::future_error(std::future_errc::no_state);
+            state_->set_value(std::forward<Args>(args)...);
+        }
+
+        void set_exception(std::exception_ptr e)
+        {
+            if (!state_)
+                throw std::future_error(std::future_errc::no_state);
+            state_->set_exception(std::move(e));
+        }
+
+        // invokes callable and stores its result or exception
+        template <typename Callable>
+        void set_from(Callable&& callable)
+        {
+            try
+            {
+                if constexpr (std::is_void_v<T>)
+                {
+                    std::invoke(callable);
+                    set_value();
+                }
+                else
+                    set_value(std::invoke(callable));
+            }
+            catch (...)
+            {
+                set_exception(std::current_exception());
+            }
+        }
+
+    private:
+        void abandon() noexcept
+        {
+            if (!state_)
+                return;
+
+            if (!state_->is_ready())
+            {
+                try
+                {
+                    state_->set_exception(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+                }
+                catch (...)
+                {
+                }
+            }
+
+            std::exchange(state_, nullptr)->release();
+        }
+    };
+
+    // returns a future which becomes ready when all futures are ready (no thread is blocked)
+    template <typename InputIt>
+    auto when_all(InputIt first, InputIt last)
+    {
+        using FutureT = typename std::iterator_traits<InputIt>::value_type;
+
+        struct Context
+        {
+            std::vector<FutureT> futures;
+            std::atomic<size_t> no_of_pending;
+            Promise<std::vector<FutureT>> promise;
+        };
+
+        auto context = std::make_shared<Context>();
+        auto result = context->promise.get_future();
+
+        std::vector<FutureT> futures;
+        std::move(first, last, std::back_inserter(futures));
+        context->futures.resize(futures.size());
+        context->no_of_pending.store(futures.size() + 1, std::memory_order_relaxed);
+
+        auto complete_one = [](Context& ctx) {
+            if (ctx.no_of_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                ctx.promise.set_value(std::move(ctx.futures));
+        };
+
+        for (size_t i = 0; i < futures.size(); ++i)
+        {
+            futures[i].on_ready([context, i, complete_one](FutureT ready) {
+                context->futures[i] = std::move(ready);
+                complete_one(*context);
+            });
+        }
+
+        complete_one(*context); // extra count - the promise is not set while continuations are being attached
+
+        return result;
+    }
+
+    namespace detail
+    {
+        template <typename Context, typename... Ts, size_t... Is>
+        void attach_all(const std::shared_ptr<Context>& context, std::index_sequence<Is...>, Future<Ts>&... futures)
+        {
+            (futures.on_ready([context](Future<Ts> ready) {
+                std::get<Is>(context->futures) = std::move(ready);
+                context->complete_one();
+            }), ...);
+        }
+    }
+
+    template <typename... Ts>
+    Future<std::tuple<Future<Ts>...>> when_all(Future<Ts>&&... futures)
+    {
+        struct Context
+        {
+            std::tuple<Future<Ts>...> futures;
+            std::atomic<size_t> no_of_pending {sizeof...(Ts) + 1};
+            Promise<std::tuple<Future<Ts>...>> promise;
+
+            void complete_one()
+            {
+                if (no_of_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    promise.set_value(std::move(futures));
+            }
+        };
+
+        auto context = std::make_shared<Context>();
+        auto result = context->promise.get_future();
+
+        detail::attach_all(context, std::index_sequence_for<Ts...> {}, futures...);
+        context->complete_one();
+
+        return result;
+    }
+
+    // returns a future which becomes ready when the first of the futures is ready
+    // (results of the others are discarded; index == size_t(-1) for an empty range)
+    template <typename InputIt>
+    auto when_any(InputIt first, InputIt last)
+    {
+        using FutureT = typename std::iterator_traits<InputIt>::value_type;
+        using ValueT = decltype(std::declval<FutureT&>().get());
+
+        struct Context
+        {
+            std::atomic<bool> done {false};
+            Promise<WhenAnyResult<ValueT>> promise;
+        };
+
+        auto context = std::make_shared<Context>();
+        auto result = context->promise.get_future();
+
+        if (first == last)
+        {
+            context->promise.set_value(WhenAnyResult<ValueT> {static_cast<size_t>(-1), FutureT {}});
+            return result;
+        }
+
+        for (size_t i = 0; first != last; ++first, ++i)
+        {
+            first->on_ready([context, i](FutureT ready) {
+                if (!context->done.exchange(true, std::memory_order_acq_rel))
+                    context->promise.set_value(WhenAnyResult<ValueT> {i, std::move(ready)});
+            });
+        }
+
+        return result;
+    }
+
+    // wraps callable into a move-only task which fulfils the returned future when invoked
+    template <typename Callable>
+    auto make_packaged_task(Callable&& callable)
+    {
+        using ResultT = std::invoke_result_t<std::decay_t<Callable>&>;
+
+        Promise<ResultT> promise;
+        Future<ResultT> future = promise.get_future();
+
+        Task task {[promise = std::move(promise), callable = std::forward<Callable>(callable)]() mutable {
+            promise.set_from(callable);
+        }};
+
+        return std::pair {std::move(task), std::move(future)};
+    }
+}
+
+#endif // FUTURE_HPP
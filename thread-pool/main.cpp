@@ -1,9 +1,17 @@
+#include "allocation_counter.hpp"
+#include "parallel_algorithms.hpp"
+#include "thread_pool.hpp"
 #include "thread_safe_queue.hpp"
+#include "work_stealing_thread_pool.hpp"
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <chrono>
 #include <functional>
+#include <memory>
+#include <numeric>
+#include <optional>
 #include <iostream>
 #include <string>
 #include <thread>
@@ -28,70 +36,6 @@ void background_work(size_t id, const std::string& text, std::chrono::millisecon
     std::cout << "bw#" << id << " is finished..." << std::endl;
 }
 
-class ThreadPool
-{
-public:
-    using Task = std::function<void()>;
-
-    ThreadPool(uint8_t num_of_threads = std::thread::hardware_concurrency())
-    {
-        for (uint8_t i {0}; i < num_of_threads; ++i)
-        {
-            thd_pool_.emplace_back([this]
-                { run(); });
-        }
-    }
-
-    ThreadPool(const ThreadPool&) = delete;
-    ThreadPool& operator=(const ThreadPool&) = delete;
-
-    ~ThreadPool()
-    {
-        for (auto& t : thd_pool_)
-        {
-            queue_tasks_.push(end_of_work_);
-        }
-        for (auto& t : thd_pool_)
-        {
-            t.join();
-        }
-    }
-
-
-    template <typename Callable>
-    auto submit(Callable&& task)
-    {
-        // if (!task)
-        //     throw std::invalid_argument("Empty function is not allowed");
-
-        using ResultT = decltype(task());
-        auto pt = std::make_shared<std::packaged_task<ResultT()>>(std::forward<Callable>(task));
-        auto f = pt->get_future();
-                
-        queue_tasks_.push([pt] { (*pt)(); });
-        return f;
-    }
-
-private:
-    static inline const Task end_of_work_ {};
-
-    void run()
-    {
-        Task task;
-        while (true)
-        {
-            queue_tasks_.pop(task);
-            if (task)
-                task();
-            else
-                return;
-        }
-    }
-
-    std::vector<std::thread> thd_pool_ {};
-    ThreadSafeQueue<Task> queue_tasks_ {};
-};
-
 namespace ver_1_1
 {
     class ThreadPool
@@ -162,15 +106,412 @@ int calculate_square(int x)
     return x * x;
 }
 
+// throughput: no_of_roots tasks submitted from main thread,
+// each of them fans out no_of_children short tasks from inside the pool
+template <typename Pool>
+void benchmark_throughput(const std::string& name, size_t no_of_roots, size_t no_of_children)
+{
+    Pool pool;
+
+    std::atomic<size_t> tasks_left {no_of_roots * no_of_children};
+    std::promise<void> all_done;
+    auto f_all_done = all_done.get_future();
+
+    const auto start = std::chrono::high_resolution_clock::now();
+
+    for (size_t r = 0; r < no_of_roots; ++r)
+    {
+        pool.submit([&] {
+            for (size_t c = 0; c < no_of_children; ++c)
+            {
+                pool.submit([&, c] {
+                    volatile size_t work = c * c;
+                    (void)work;
+                    if (tasks_left.fetch_sub(1) == 1)
+                        all_done.set_value();
+                });
+            }
+        });
+    }
+
+    f_all_done.wait();
+
+    const auto end = std::chrono::high_resolution_clock::now();
+    const auto elapsed_time = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    const size_t no_of_tasks = no_of_roots * (no_of_children + 1);
+
+    std::cout << name << " - threads: " << pool.size() << "; tasks: " << no_of_tasks
+              << "; elapsed = " << elapsed_time << "ms; throughput = "
+              << no_of_tasks * 1000 / std::max<long long>(elapsed_time, 1) << " tasks/s" << std::endl;
+}
+
+// the way ThreadPool::submit() used to wrap a callable: shared_ptr<packaged_task> inside std::function
+template <typename Callable>
+auto legacy_wrap(Callable&& task)
+{
+    using ResultT = decltype(task());
+    auto pt = std::make_shared<std::packaged_task<ResultT()>>(std::forward<Callable>(task));
+    auto f = pt->get_future();
+
+    std::function<void()> wrapped_task = [pt] { (*pt)(); };
+    return std::pair {std::move(wrapped_task), std::move(f)};
+}
+
+void benchmark_allocations(size_t no_of_tasks)
+{
+    std::string text = "text";
+
+    {
+        const size_t start = no_of_allocations.load();
+        for (size_t i = 0; i < no_of_tasks; ++i)
+        {
+            auto [task, f] = legacy_wrap([text, i] { return text.size() + i; });
+            task();
+            f.get();
+        }
+        const size_t allocations = no_of_allocations.load() - start;
+        std::cout << "std::function + shared_ptr<packaged_task> - allocations per task: "
+                  << static_cast<double>(allocations) / no_of_tasks << std::endl;
+    }
+
+    {
+        const size_t start = no_of_allocations.load();
+        for (size_t i = 0; i < no_of_tasks; ++i)
+        {
+            auto [task, f] = ext::make_packaged_task([text, i] { return text.size() + i; });
+            task();
+            f.get();
+        }
+        const size_t allocations = no_of_allocations.load() - start;
+        std::cout << "ext::Task + ext::Promise - allocations per task: "
+                  << static_cast<double>(allocations) / no_of_tasks << std::endl;
+    }
+
+    {
+        ThreadPool pool {1};
+        std::vector<ext::Future<size_t>> results;
+        results.reserve(no_of_tasks);
+
+        const size_t start = no_of_allocations.load();
+        for (size_t i = 0; i < no_of_tasks; ++i)
+            results.push_back(pool.submit([text, i] { return text.size() + i; }));
+        for (auto& f : results)
+            f.get();
+        const size_t allocations = no_of_allocations.load() - start;
+        std::cout << "ThreadPool::submit() - allocations per task (including queue): "
+                  << static_cast<double>(allocations) / no_of_tasks << std::endl;
+    }
+}
+
+void benchmark_bulk_submit(size_t no_of_tasks)
+{
+    ThreadPool pool;
+
+    {
+        const auto start = std::chrono::high_resolution_clock::now();
+
+        std::vector<ext::Future<size_t>> results;
+        results.reserve(no_of_tasks);
+        for (size_t i = 0; i < no_of_tasks; ++i)
+            results.push_back(pool.submit([i] { return i * i; }));
+        for (auto& f : results)
+            f.get();
+
+        const auto end = std::chrono::high_resolution_clock::now();
+        std::cout << "submit() x " << no_of_tasks << " - elapsed = "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms" << std::endl;
+    }
+
+    {
+        const auto start = std::chrono::high_resolution_clock::now();
+
+        auto results = pool.submit_n(no_of_tasks, [](size_t i) { return i * i; });
+        for (auto& f : results)
+            f.get();
+
+        const auto end = std::chrono::high_resolution_clock::now();
+        std::cout << "submit_n(" << no_of_tasks << ") - elapsed = "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms" << std::endl;
+    }
+}
+
+// cost per trivial task - build with and without THREAD_POOL_STATS to see the overhead of the instrumentation
+void benchmark_task_stats(size_t no_of_tasks)
+{
+    ThreadPool pool;
+
+    const auto start = std::chrono::high_resolution_clock::now();
+
+    auto results = pool.submit_n(no_of_tasks, [](size_t i) { return i * i; });
+    for (auto& f : results)
+        f.get();
+
+    const auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "submit_n(" << no_of_tasks << ") - elapsed = " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+              << "ms; " << std::chrono::duration<double, std::nano>(end - start).count() / no_of_tasks << "ns per task" << std::endl;
+
+#ifdef THREAD_POOL_STATS
+    const auto stats = pool.task_stats();
+
+    auto print = [](const std::string& name, const ext::HistogramSnapshot& h, const std::string& unit) {
+        std::cout << "  " << name << ": count = " << h.count << "; mean = " << h.mean << unit << "; p50 = " << h.p50 << unit
+                  << "; p99 = " << h.p99 << unit << "; p999 = " << h.p999 << unit << "; max = " << h.max << unit << std::endl;
+    };
+
+    print("wait time", stats.wait_time_ns, "ns");
+    print("service time", stats.service_time_ns, "ns");
+    print("queue depth", stats.queue_depth, "");
+
+    std::cout << "  busy ratio:";
+    for (double ratio : stats.busy_ratio)
+        std::cout << " " << ratio;
+    std::cout << std::endl;
+#endif
+}
+
+// parallel_inclusive_scan() vs. std::inclusive_scan():
+//  - sizes not divisible by the number of chunks & smaller than the number of participants
+//  - string concatenation is associative but not commutative - chunks must be combined in order
+void check_parallel_inclusive_scan()
+{
+    bool all_equal = true;
+
+    for (size_t no_of_threads : {1, 3, 6})
+    {
+        ThreadPool pool {no_of_threads};
+
+        for (size_t size : {0, 1, 2, 3, 5, 7, 10, 1'000, 1'001, 12'345})
+        {
+            std::vector<long> numbers(size);
+            std::iota(numbers.begin(), numbers.end(), -100L);
+
+            std::vector<long> expected(size);
+            std::inclusive_scan(numbers.begin(), numbers.end(), expected.begin(), std::plus<>{});
+            std::vector<long> result(size);
+            ext::parallel_inclusive_scan(pool, numbers.begin(), numbers.end(), result.begin(), std::plus<>{});
+
+            std::vector<std::string> words(size % 100);
+            for (size_t i = 0; i < words.size(); ++i)
+                words[i] = std::to_string(i) + ";";
+
+            std::vector<std::string> expected_words(words.size());
+            std::inclusive_scan(words.begin(), words.end(), expected_words.begin(), std::plus<>{});
+            std::vector<std::string> result_words(words.size());
+            ext::parallel_inclusive_scan(pool, words.begin(), words.end(), result_words.begin(), std::plus<>{});
+
+            if (result != expected || result_words != expected_words)
+            {
+                all_equal = false;
+                std::cout << "parallel_inclusive_scan mismatch - threads: " << no_of_threads << ", size: " << size << std::endl;
+            }
+        }
+    }
+
+    std::cout << "parallel_inclusive_scan == std::inclusive_scan: " << std::boolalpha << all_equal << std::endl;
+    assert(all_equal);
+}
+
+// consumer blocked on an empty queue exits as soon as stop is requested - no poison pill
+void stoppable_pop_demo()
+{
+    ThreadSafeQueue<int> q;
+    ext::StopSource stop_source;
+
+    std::thread consumer {[&q, token = stop_source.get_token()] {
+        int item;
+        while (q.pop(item, token))
+            std::cout << "consumed: " << item << std::endl;
+        std::cout << "consumer stopped" << std::endl;
+    }};
+
+    q.push({1, 2, 3});
+    std::this_thread::sleep_for(100ms);
+    stop_source.request_stop();
+
+    consumer.join();
+}
+
+// time of shutdown with a backlog of no_of_tasks short tasks:
+//  - destructor runs the whole backlog
+//  - shutdown_now() cancels it and stops a long running task which polls its stop token
+void benchmark_shutdown(size_t no_of_tasks, std::chrono::microseconds task_duration)
+{
+    auto submit_backlog = [&](ThreadPool& pool, std::vector<ext::Future<void>>& results) {
+        for (size_t i = 0; i < no_of_tasks; ++i)
+            results.push_back(pool.submit([task_duration] { std::this_thread::sleep_for(task_duration); }));
+    };
+
+    {
+        std::optional<ThreadPool> pool {std::in_place};
+        std::vector<ext::Future<void>> results;
+        submit_backlog(*pool, results);
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        pool.reset();
+        const auto end = std::chrono::high_resolution_clock::now();
+
+        std::cout << "~ThreadPool() with backlog of " << no_of_tasks << " tasks - elapsed = "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms" << std::endl;
+    }
+
+    {
+        // the long running task occupies one worker - with a single one a bounded queue fills up and submit() blocks forever
+        ThreadPool pool {std::max(std::thread::hardware_concurrency(), 2u)};
+        std::vector<ext::Future<void>> results;
+
+        results.push_back(pool.submit([](ext::StopToken token) {
+            while (!token.stop_requested())
+                std::this_thread::sleep_for(1ms);
+        }));
+        submit_backlog(pool, results);
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        pool.shutdown_now();
+        const auto end = std::chrono::high_resolution_clock::now();
+
+        size_t cancelled = 0;
+        for (auto& f : results)
+        {
+            try
+            {
+                f.get();
+            }
+            catch (const ext::OperationCancelled&)
+            {
+                ++cancelled;
+            }
+        }
+
+        std::cout << "shutdown_now() with backlog of " << no_of_tasks << " tasks - elapsed = "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms; cancelled = "
+                  << cancelled << std::endl;
+    }
+}
+
+#ifndef THREAD_POOL_BOUNDED_QUEUE // priorities & deadlines need PriorityTaskQueue
+// background tasks arrive slightly faster than the pool can run them (the backlog grows),
+// requests arrive between them - reports delay between submit and start of the requests
+void benchmark_priority(size_t no_of_requests, std::chrono::microseconds task_duration, std::chrono::microseconds request_interval)
+{
+    auto busy_work = [task_duration] {
+        const auto end = std::chrono::steady_clock::now() + task_duration;
+        while (std::chrono::steady_clock::now() < end)
+            ;
+    };
+
+    auto run = [&](const std::string& name, auto submit_request) {
+        ThreadPool pool;
+        const size_t background_per_request = pool.size() * (request_interval / task_duration + 1);
+
+        std::vector<std::chrono::steady_clock::time_point> submitted(no_of_requests);
+        std::vector<std::chrono::steady_clock::time_point> started(no_of_requests);
+        std::vector<ext::Future<void>> requests;
+
+        for (size_t i = 0; i < no_of_requests; ++i)
+        {
+            pool.submit_n(background_per_request, [&](size_t) { busy_work(); });
+
+            submitted[i] = std::chrono::steady_clock::now();
+            requests.push_back(submit_request(pool, [&started, i] { started[i] = std::chrono::steady_clock::now(); }));
+            std::this_thread::sleep_for(request_interval);
+        }
+
+        for (auto& f : requests)
+            f.get();
+
+        pool.shutdown_now(); // the rest of the backlog is cancelled
+
+        std::vector<long long> latencies;
+        for (size_t i = 0; i < no_of_requests; ++i)
+            latencies.push_back(std::chrono::duration_cast<std::chrono::microseconds>(started[i] - submitted[i]).count());
+        std::sort(latencies.begin(), latencies.end());
+
+        auto percentile = [&](double p) { return latencies[static_cast<size_t>(p * (latencies.size() - 1))]; };
+
+        std::cout << name << " - request latency: p50 = " << percentile(0.5) << "us; p99 = " << percentile(0.99)
+                  << "us; p999 = " << percentile(0.999) << "us" << std::endl;
+    };
+
+    run("submit(f)", [](ThreadPool& pool, auto request) { return pool.submit(request); });
+    run("submit(TaskPriority::high, f)", [](ThreadPool& pool, auto request) { return pool.submit(TaskPriority::high, request); });
+    run("submit_before(now + 2ms, f)", [](ThreadPool& pool, auto request) {
+        return pool.submit_before(std::chrono::steady_clock::now() + 2ms, request);
+    });
+}
+#endif
+
+// bursts of I/O-like tasks separated by idle periods - fixed pool vs elastic pool
+void benchmark_elastic(size_t no_of_bursts, size_t burst_size, std::chrono::microseconds task_duration, std::chrono::milliseconds idle_time)
+{
+    auto run = [&](const std::string& name, ThreadPool& pool) {
+        for (size_t burst = 0; burst < no_of_bursts; ++burst)
+        {
+            const auto start = std::chrono::high_resolution_clock::now();
+
+            std::vector<ext::Future<void>> results;
+            for (size_t i = 0; i < burst_size; ++i)
+                results.push_back(pool.submit([task_duration] { std::this_thread::sleep_for(task_duration); }));
+            for (auto& f : results)
+                f.get();
+
+            const auto end = std::chrono::high_resolution_clock::now();
+            const auto busy = pool.stats();
+
+            std::this_thread::sleep_for(idle_time);
+            const auto idle = pool.stats();
+
+            std::cout << name << " - burst #" << burst << ": elapsed = "
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms; threads = "
+                      << busy.no_of_threads << " -> " << idle.no_of_threads << " after idle; peak = " << idle.peak_no_of_threads
+                      << "; spawned (queue depth/wait time) = " << idle.spawned_for_queue_depth << "/" << idle.spawned_for_wait_time
+                      << "; retired = " << idle.retired << std::endl;
+        }
+    };
+
+    {
+        ThreadPool pool;
+        run("ThreadPool (fixed)", pool);
+    }
+
+    {
+        ThreadPool pool {ThreadPool::ElasticOptions {1, 64, 100ms}};
+        run("ThreadPool (elastic 1..64)", pool);
+    }
+}
+
 int main()
 {
+    check_parallel_inclusive_scan();
+    stoppable_pop_demo();
+    benchmark_shutdown(2'000, 1ms);
+#ifndef THREAD_POOL_BOUNDED_QUEUE
+    benchmark_priority(1'000, 50us, 200us);
+#endif
+    benchmark_elastic(3, 2'000, 1ms, 300ms);
+
+    benchmark_allocations(100'000);
+    benchmark_bulk_submit(100'000);
+    benchmark_task_stats(1'000'000);
+
+#ifndef THREAD_POOL_BOUNDED_QUEUE // tasks which submit subtasks block on the full bounded queue
+    benchmark_throughput<ThreadPool>("ThreadPool (single queue)", 1'000, 100);
+#endif
+    benchmark_throughput<WorkStealingThreadPool>("WorkStealingThreadPool", 1'000, 100);
+
     ThreadPool thd_pool {6};
 
     for (int i = 1; i < 20; ++i)
         thd_pool.submit([=]
             { background_work(i, "Thread Pool#" + std::to_string(i), 100ms); });
 
-    std::vector<std::tuple<int, std::future<int>>> f_squares;
+    std::vector<std::function<int()>> bulk_tasks = {[] { return 1; }, [] { return 2; }, [] { return 3; }};
+    for (auto& f : thd_pool.submit_bulk(bulk_tasks))
+        std::cout << "bulk result: " << f.get() << std::endl;
+
+    auto ptr = std::make_unique<std::string>("move-only lambda");
+    thd_pool.submit([ptr = std::move(ptr)] { std::cout << *ptr << std::endl; });
+
+    std::vector<std::tuple<int, ext::Future<int>>> f_squares;
 
     for (int i = 1; i < 20; ++i)
         f_squares.push_back(std::tuple(i, thd_pool.submit([i] { return calculate_square(i); })));
@@ -188,4 +529,41 @@ int main()
             std::cerr << e.what() << '\n';
         }        
     }
+
+    // the first of redundant requests wins
+    std::vector<ext::Future<std::string>> replicas;
+    replicas.push_back(thd_pool.submit([] { std::this_thread::sleep_for(200ms); return "replica#1"s; }));
+    replicas.push_back(thd_pool.submit([] { std::this_thread::sleep_for(50ms); return "replica#2"s; }));
+
+    auto first_printed = ext::when_any(replicas.begin(), replicas.end())
+        .then([](ext::Future<ext::WhenAnyResult<std::string>> first) {
+            auto [index, f] = first.get();
+            std::cout << "first response: " << f.get() << " (index " << index << ")" << std::endl;
+        });
+
+    first_printed.wait();
+
+    // squares again - without a thread blocked on get(): results are summed and printed by continuations
+    std::vector<ext::Future<int>> squares;
+    for (int i = 1; i < 20; ++i)
+        squares.push_back(thd_pool.submit([i] { return calculate_square(i); }));
+
+    auto sum_printed = ext::when_all(squares.begin(), squares.end())
+        .then([](ext::Future<std::vector<ext::Future<int>>> all) {
+            int sum = 0;
+            for (auto& f : all.get())
+            {
+                try
+                {
+                    sum += f.get();
+                }
+                catch (const std::exception&)
+                {
+                }
+            }
+            return sum;
+        })
+        .then(thd_pool, [](ext::Future<int> sum) { std::cout << "sum of squares (continuation on pool): " << sum.get() << std::endl; });
+
+    sum_printed.wait();
 }
@@ -0,0 +1,218 @@
+#ifndef PARALLEL_ALGORITHMS_HPP
+#define PARALLEL_ALGORITHMS_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <numeric>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+// Parallel algorithms running on a pool with submit_n() (ThreadPool)
+//  - the calling thread takes part in the work, so it must not be a worker of the same pool
+//  - index ranges are split into chunks on demand (guided self-scheduling)
+//  - every participant keeps its partial result in a local variable and publishes it
+//    once to its own cache line - no false sharing between workers
+namespace ext
+{
+    namespace detail
+    {
+        constexpr size_t cache_line_size = 64;
+
+        template <typename T>
+        struct alignas(cache_line_size) Padded
+        {
+            T value {};
+        };
+
+        // hands out chunks of remaining / (2 * no_of_participants) iterations (but at least min_grain):
+        // big chunks at the beginning - low overhead, small chunks at the end - good load balancing
+        template <typename Index>
+        class ChunkDispenser
+        {
+            std::atomic<Index> next_;
+            const Index last_;
+            const Index divisor_;
+            const Index min_grain_;
+
+        public:
+            ChunkDispenser(Index first, Index last, size_t no_of_participants, Index min_grain)
+                : next_ {first}
+                , last_ {last}
+                , divisor_ {static_cast<Index>(2 * no_of_participants)}
+                , min_grain_ {std::max<Index>(min_grain, 1)}
+            {
+            }
+
+            bool next_chunk(Index& chunk_first, Index& chunk_last)
+            {
+                Index current = next_.load(std::memory_order_relaxed);
+
+                while (current < last_)
+                {
+                    const Index remaining = last_ - current;
+                    const Index chunk_size = std::min(std::max(remaining / divisor_, min_grain_), remaining);
+
+                    if (next_.compare_exchange_weak(current, current + chunk_size, std::memory_order_relaxed))
+                    {
+                        chunk_first = current;
+                        chunk_last = current + chunk_size;
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+        };
+
+        // runs participant(0) ... participant(n-1): n-1 of them on the pool, the last one on the calling thread
+        template <typename Pool, typename Participant>
+        void run_participants(Pool& pool, size_t no_of_participants, Participant participant)
+        {
+            auto futures = pool.submit_n(no_of_participants - 1, [&participant](size_t id) { participant(id); });
+
+            std::exception_ptr caller_exception;
+            try
+            {
+                participant(no_of_participants - 1);
+            }
+            catch (...)
+            {
+                caller_exception = std::current_exception();
+            }
+
+            // all tasks must finish before the locals they refer to go out of scope
+            for (auto& f : futures)
+                f.wait();
+
+            if (caller_exception)
+                std::rethrow_exception(caller_exception);
+
+            for (auto& f : futures)
+                f.get();
+        }
+
+        template <typename Pool>
+        size_t no_of_participants(const Pool& pool)
+        {
+            return pool.size() + 1;
+        }
+    }
+
+    // reduces chunks of [first, last): chunk_body(chunk_first, chunk_last) -> T
+    // reduce must be associative and commutative - partial results are combined in any order
+    template <typename Pool, typename Index, typename T, typename Reduce, typename ChunkBody>
+    T parallel_reduce(Pool& pool, Index first, Index last, T init, Reduce reduce, ChunkBody chunk_body, Index min_grain = 1)
+    {
+        static_assert(std::is_integral_v<Index>, "Index must be an integral type");
+
+        if (first >= last)
+            return init;
+
+        const size_t no_of_participants = detail::no_of_participants(pool);
+        detail::ChunkDispenser<Index> chunks {first, last, no_of_participants, min_grain};
+        std::vector<detail::Padded<std::optional<T>>> partial_results(no_of_participants);
+
+        detail::run_participants(pool, no_of_participants, [&](size_t id) {
+            std::optional<T> partial_result;
+
+            Index chunk_first, chunk_last;
+            while (chunks.next_chunk(chunk_first, chunk_last))
+            {
+                T chunk_result = chunk_body(chunk_first, chunk_last);
+                partial_result = partial_result
+                    ? reduce(std::move(*partial_result), std::move(chunk_result))
+                    : std::move(chunk_result);
+            }
+
+            partial_results[id].value = std::move(partial_result);
+        });
+
+        for (auto& partial_result : partial_results)
+        {
+            if (partial_result.value)
+                init = reduce(std::move(init), std::move(*partial_result.value));
+        }
+
+        return init;
+    }
+
+    // reduce(init, transform(first), ..., transform(last - 1))
+    template <typename Pool, typename Index, typename T, typename Reduce, typename Transform>
+    T parallel_transform_reduce(Pool& pool, Index first, Index last, T init, Reduce reduce, Transform transform, Index min_grain = 1)
+    {
+        return parallel_reduce(pool, first, last, std::move(init), reduce, [&](Index chunk_first, Index chunk_last) {
+            T result = transform(chunk_first);
+            for (Index i = chunk_first + 1; i < chunk_last; ++i)
+                result = reduce(std::move(result), transform(i));
+            return result;
+        }, min_grain);
+    }
+
+    // body(i) for every i in [first, last)
+    template <typename Pool, typename Index, typename Body>
+    void parallel_for(Pool& pool, Index first, Index last, Body body, Index min_grain = 1)
+    {
+        static_assert(std::is_integral_v<Index>, "Index must be an integral type");
+
+        if (first >= last)
+            return;
+
+        const size_t no_of_participants = detail::no_of_participants(pool);
+        detail::ChunkDispenser<Index> chunks {first, last, no_of_participants, min_grain};
+
+        detail::run_participants(pool, no_of_participants, [&](size_t) {
+            Index chunk_first, chunk_last;
+            while (chunks.next_chunk(chunk_first, chunk_last))
+            {
+                for (Index i = chunk_first; i < chunk_last; ++i)
+                    body(i);
+            }
+        });
+    }
+
+    // the same as std::inclusive_scan(first, last, d_first, op) - op must be associative
+    // two passes over equal static chunks: reduce every chunk, then scan every chunk with the offset of its predecessors
+    template <typename Pool, typename RandomIt, typename OutputIt, typename BinaryOp>
+    OutputIt parallel_inclusive_scan(Pool& pool, RandomIt first, RandomIt last, OutputIt d_first, BinaryOp op)
+    {
+        using T = typename std::iterator_traits<RandomIt>::value_type;
+
+        const size_t size = std::distance(first, last);
+        const size_t no_of_chunks = std::min(detail::no_of_participants(pool), size);
+
+        if (no_of_chunks <= 1)
+            return std::inclusive_scan(first, last, d_first, op);
+
+        auto chunk_begin = [=](size_t chunk) { return chunk * size / no_of_chunks; };
+
+        std::vector<detail::Padded<T>> chunk_sums(no_of_chunks);
+        detail::run_participants(pool, no_of_chunks, [&](size_t chunk) {
+            if (chunk == no_of_chunks - 1)
+                return; // the sum of the last chunk is never used as an offset
+
+            auto chunk_first = first + chunk_begin(chunk);
+            auto chunk_last = first + chunk_begin(chunk + 1);
+            chunk_sums[chunk].value = std::accumulate(std::next(chunk_first), chunk_last, *chunk_first, op);
+        });
+
+        for (size_t chunk = 1; chunk < no_of_chunks - 1; ++chunk)
+            chunk_sums[chunk].value = op(chunk_sums[chunk - 1].value, chunk_sums[chunk].value);
+
+        detail::run_participants(pool, no_of_chunks, [&](size_t chunk) {
+            auto chunk_first = first + chunk_begin(chunk);
+            auto chunk_last = first + chunk_begin(chunk + 1);
+            auto chunk_d_first = std::next(d_first, chunk_begin(chunk));
+
+            if (chunk == 0)
+                std::inclusive_scan(chunk_first, chunk_last, chunk_d_first, op);
+            else
+                std::inclusive_scan(chunk_first, chunk_last, chunk_d_first, op, chunk_sums[chunk - 1].value);
+        });
+
+        return std::next(d_first, size);
+    }
+}
+
+#endif // PARALLEL_ALGORITHMS_HPP
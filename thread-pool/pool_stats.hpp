@@ -0,0 +1,284 @@
+#ifndef POOL_STATS_HPP
+#define POOL_STATS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define POOL_STATS_RDTSC
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define POOL_STATS_RDTSC
+#endif
+
+// 1 of THREAD_POOL_STATS_SAMPLE_PERIOD tasks is timed - define it as 1 to record every task
+#ifndef THREAD_POOL_STATS_SAMPLE_PERIOD
+#define THREAD_POOL_STATS_SAMPLE_PERIOD 64
+#endif
+
+namespace ext
+{
+    // picks on average every period-th event - a countdown owned by one thread, no timestamp for the others
+    //  - the countdown is random (uniform in [0, 2 * period - 2]) - a fixed one aliases with periodic workloads,
+    //    e.g. the wait after every batch of 1024 tasks would be sampled always or never
+    class Sampler
+    {
+    public:
+        static constexpr uint32_t period = THREAD_POOL_STATS_SAMPLE_PERIOD;
+
+        bool next() noexcept
+        {
+            if (countdown_ != 0)
+            {
+                --countdown_;
+                return false;
+            }
+
+            countdown_ = period > 1 ? random() % (2 * period - 1) : 0;
+            return true;
+        }
+
+    private:
+        // xorshift32 - every sampler gets its own seed
+        uint32_t random() noexcept
+        {
+            state_ ^= state_ << 13;
+            state_ ^= state_ >> 17;
+            state_ ^= state_ << 5;
+            return state_;
+        }
+
+        static uint32_t next_seed() noexcept
+        {
+            static std::atomic<uint32_t> no_of_samplers {0};
+            return (no_of_samplers.fetch_add(1, std::memory_order_relaxed) + 1) * 2654435761u; // never 0
+        }
+
+        uint32_t state_ {next_seed()};
+        uint32_t countdown_ {random() % period};
+    };
+
+    // cheapest timestamp available: TSC on x86 (a few ns), steady_clock ticks elsewhere
+    // ticks are converted to nanoseconds only when a snapshot is taken
+    struct CycleClock
+    {
+        static uint64_t now() noexcept
+        {
+#ifdef POOL_STATS_RDTSC
+            return __rdtsc();
+#else
+            return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+        }
+
+        static double ns_per_tick()
+        {
+#ifdef POOL_STATS_RDTSC
+            // measured once against steady_clock (constant TSC is assumed)
+            static const double ratio = [] {
+                const auto start_time = std::chrono::steady_clock::now();
+                const uint64_t start_ticks = now();
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                const uint64_t end_ticks = now();
+                const auto end_time = std::chrono::steady_clock::now();
+
+                return std::chrono::duration<double, std::nano>(end_time - start_time).count() / (end_ticks - start_ticks);
+            }();
+            return ratio;
+#else
+            return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::duration {1}).count();
+#endif
+        }
+    };
+
+    struct HistogramSnapshot
+    {
+        uint64_t count {0};
+        double min {0};
+        double mean {0};
+        double max {0};
+        double p50 {0};
+        double p99 {0};
+        double p999 {0};
+    };
+
+    // HDR-style log-linear histogram: 16 linear sub-buckets per power of two (relative error < 6.25%)
+    //  - record() is wait-free for a single writer thread (relaxed load + store, no RMW)
+    //  - other threads may read the counters at any time (merge into a snapshot)
+    class Histogram
+    {
+    public:
+        static constexpr unsigned sub_bucket_bits = 4;
+        static constexpr size_t no_of_sub_buckets = size_t {1} << sub_bucket_bits;
+        static constexpr size_t no_of_buckets = (64 - sub_bucket_bits + 1) * no_of_sub_buckets;
+
+        using Counts = std::array<uint64_t, no_of_buckets>;
+
+        void record(uint64_t value) noexcept
+        {
+            auto& counter = counts_[index_of(value)];
+            counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            sum_.store(sum_.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        void merge_into(Counts& counts, uint64_t& sum) const noexcept
+        {
+            for (size_t i = 0; i < no_of_buckets; ++i)
+                counts[i] += counts_[i].load(std::memory_order_relaxed);
+            sum += sum_.load(std::memory_order_relaxed);
+        }
+
+        void reset() noexcept
+        {
+            for (auto& counter : counts_)
+                counter.store(0, std::memory_order_relaxed);
+            sum_.store(0, std::memory_order_relaxed);
+        }
+
+        static size_t index_of(uint64_t value) noexcept
+        {
+            if (value < no_of_sub_buckets)
+                return static_cast<size_t>(value);
+
+            const unsigned shift = most_significant_bit(value) - sub_bucket_bits;
+            return (shift + 1) * no_of_sub_buckets + ((value >> shift) & (no_of_sub_buckets - 1));
+        }
+
+        // middle of the range of values counted in the bucket
+        static double value_of(size_t index) noexcept
+        {
+            if (index < no_of_sub_buckets)
+                return static_cast<double>(index);
+
+            const unsigned shift = static_cast<unsigned>(index / no_of_sub_buckets - 1);
+            const double lowest = static_cast<double>((no_of_sub_buckets + index % no_of_sub_buckets) << shift);
+            return lowest + static_cast<double>(uint64_t {1} << shift) / 2;
+        }
+
+        // scale converts recorded units (e.g. ticks) to reported units (e.g. ns)
+        static HistogramSnapshot summarize(const Counts& counts, uint64_t sum, double scale = 1.0)
+        {
+            HistogramSnapshot snapshot;
+            for (auto c : counts)
+                snapshot.count += c;
+
+            if (snapshot.count == 0)
+                return snapshot;
+
+            snapshot.mean = scale * static_cast<double>(sum) / static_cast<double>(snapshot.count);
+
+            const uint64_t rank_p50 = rank(snapshot.count, 0.5);
+            const uint64_t rank_p99 = rank(snapshot.count, 0.99);
+            const uint64_t rank_p999 = rank(snapshot.count, 0.999);
+
+            uint64_t cumulative = 0;
+            bool min_found = false;
+            for (size_t i = 0; i < counts.size(); ++i)
+            {
+                if (counts[i] == 0)
+                    continue;
+
+                const uint64_t previous = cumulative;
+                cumulative += counts[i];
+                const double value = scale * value_of(i);
+
+                if (!min_found)
+                {
+                    snapshot.min = value;
+                    min_found = true;
+                }
+                if (previous < rank_p50 && cumulative >= rank_p50)
+                    snapshot.p50 = value;
+                if (previous < rank_p99 && cumulative >= rank_p99)
+                    snapshot.p99 = value;
+                if (previous < rank_p999 && cumulative >= rank_p999)
+                    snapshot.p999 = value;
+                snapshot.max = value;
+            }
+
+            return snapshot;
+        }
+
+    private:
+        static unsigned most_significant_bit(uint64_t value) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return 63 - static_cast<unsigned>(__builtin_clzll(value));
+#else
+            unsigned msb = 0;
+            while (value >>= 1)
+                ++msb;
+            return msb;
+#endif
+        }
+
+        static uint64_t rank(uint64_t count, double percentile) noexcept
+        {
+            const auto r = static_cast<uint64_t>(percentile * static_cast<double>(count) + 0.5);
+            return r < 1 ? 1 : r;
+        }
+
+        std::array<std::atomic<uint64_t>, no_of_buckets> counts_ {};
+        std::atomic<uint64_t> sum_ {0};
+    };
+
+    // written only by its worker thread - only sampled tasks are recorded (see Sampler),
+    // busy and idle time are sampled together, so their ratio is not biased
+    struct alignas(64) WorkerStats
+    {
+        Histogram wait_time;    // ticks: submit -> start of the task
+        Histogram service_time; // ticks: execution of the task
+        Histogram queue_depth;  // tasks left in the queue when a task is taken
+        std::atomic<uint64_t> busy_ticks {0};
+        std::atomic<uint64_t> idle_ticks {0};
+        Sampler sampler {};
+
+        void add(std::atomic<uint64_t>& counter, uint64_t ticks) noexcept
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + ticks, std::memory_order_relaxed);
+        }
+    };
+
+    struct PoolStatsSnapshot
+    {
+        HistogramSnapshot wait_time_ns;
+        HistogramSnapshot service_time_ns;
+        HistogramSnapshot queue_depth;
+        std::vector<double> busy_ratio; // per worker slot: busy / (busy + idle)
+    };
+
+    template <typename WorkerStatsRange>
+    PoolStatsSnapshot merge_stats(const WorkerStatsRange& workers)
+    {
+        Histogram::Counts wait_counts {}, service_counts {}, depth_counts {};
+        uint64_t wait_sum = 0, service_sum = 0, depth_sum = 0;
+
+        PoolStatsSnapshot snapshot;
+
+        for (const auto& worker : workers)
+        {
+            worker->wait_time.merge_into(wait_counts, wait_sum);
+            worker->service_time.merge_into(service_counts, service_sum);
+            worker->queue_depth.merge_into(depth_counts, depth_sum);
+
+            const double busy = static_cast<double>(worker->busy_ticks.load(std::memory_order_relaxed));
+            const double idle = static_cast<double>(worker->idle_ticks.load(std::memory_order_relaxed));
+            snapshot.busy_ratio.push_back(busy + idle > 0 ? busy / (busy + idle) : 0.0);
+        }
+
+        const double ns_per_tick = CycleClock::ns_per_tick();
+        snapshot.wait_time_ns = Histogram::summarize(wait_counts, wait_sum, ns_per_tick);
+        snapshot.service_time_ns = Histogram::summarize(service_counts, service_sum, ns_per_tick);
+        snapshot.queue_depth = Histogram::summarize(depth_counts, depth_sum);
+
+        return snapshot;
+    }
+}
+
+#endif // POOL_STATS_HPP
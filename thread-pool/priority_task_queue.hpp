@@ -0,0 +1,251 @@
+#ifndef PRIORITY_TASK_QUEUE_HPP
+#define PRIORITY_TASK_QUEUE_HPP
+
+#include "stop_token.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <initializer_list>
+#include <mutex>
+#include <vector>
+
+enum class TaskPriority
+{
+    high,
+    normal,
+    low
+};
+
+// Blocking queue which pops the most urgent item first (the same interface as ThreadSafeQueue plus priorities):
+//  - every item has a deadline: push_before(item, deadline) sets it explicitly (earliest-deadline-first),
+//    push(item, priority) sets it to now + aging budget of the priority level
+//  - aging: a low priority item waits at most its budget longer than a high priority item pushed at the same time,
+//    then it wins - no starvation
+//  - one FIFO per priority level (same budget -> deadlines grow in push order, no sorting needed)
+//    and one binary heap for explicit deadlines - pop() compares only the heads
+template <typename T>
+class PriorityTaskQueue
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using TimePoint = Clock::time_point;
+    using AgingBudgets = std::array<Clock::duration, 3>; // indexed by TaskPriority
+
+    static constexpr AgingBudgets default_aging_budgets()
+    {
+        using namespace std::chrono_literals;
+        return {0ms, 10ms, 100ms};
+    }
+
+    explicit PriorityTaskQueue(const AgingBudgets& aging_budgets = default_aging_budgets())
+        : aging_budgets_ {aging_budgets}
+    {
+    }
+
+    PriorityTaskQueue(const PriorityTaskQueue&) = delete;
+    PriorityTaskQueue& operator=(const PriorityTaskQueue&) = delete;
+
+    bool empty() const
+    {
+        std::lock_guard<std::mutex> lk {mtx_q_};
+        return size_unsafe() == 0;
+    }
+
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lk {mtx_q_};
+        return size_unsafe();
+    }
+
+    void push(const T& item, TaskPriority priority = TaskPriority::normal)
+    {
+        push_item(T(item), priority);
+    }
+
+    void push(T&& item, TaskPriority priority = TaskPriority::normal)
+    {
+        push_item(std::move(item), priority);
+    }
+
+    void push(std::initializer_list<T> items)
+    {
+        push(items.begin(), items.end());
+    }
+
+    // pushes range of items (normal priority) under one lock and wakes up only as many consumers as needed
+    template <typename InputIt>
+    void push(InputIt first, InputIt last)
+    {
+        size_t no_of_items = 0;
+        size_t no_of_waiting = 0;
+
+        {
+            std::lock_guard<std::mutex> lk {mtx_q_};
+            const TimePoint deadline = Clock::now() + budget(TaskPriority::normal);
+            for (; first != last; ++first, ++no_of_items)
+                level(TaskPriority::normal).push_back(Entry {*first, deadline});
+            no_of_waiting = no_of_waiting_;
+        }
+
+        if (no_of_items >= no_of_waiting)
+            cv_q_not_empty_.notify_all();
+        else
+            for (size_t i = 0; i < no_of_items; ++i)
+                cv_q_not_empty_.notify_one();
+    }
+
+    // item has to be started before deadline - competes with other items by deadline only
+    void push_before(T item, TimePoint deadline)
+    {
+        {
+            std::lock_guard<std::mutex> lk {mtx_q_};
+            deadline_heap_.push_back(Entry {std::move(item), deadline});
+            std::push_heap(deadline_heap_.begin(), deadline_heap_.end(), LaterDeadline {});
+        }
+
+        cv_q_not_empty_.notify_one();
+    }
+
+    // non-blocking operation - returns false when queue is empty
+    bool try_pop(T& item)
+    {
+        std::lock_guard<std::mutex> lk {mtx_q_};
+        if (size_unsafe() == 0)
+            return false;
+
+        pop_most_urgent(item);
+        return true;
+    }
+
+    // blocking operation - waits if queue is empty
+    void pop(T& item)
+    {
+        std::unique_lock<std::mutex> lk {mtx_q_};
+        if (size_unsafe() == 0)
+        {
+            ++no_of_waiting_;
+            cv_q_not_empty_.wait(lk, [this] { return size_unsafe() != 0; });
+            --no_of_waiting_;
+        }
+        pop_most_urgent(item);
+    }
+
+    // blocking operation - waits if queue is empty
+    // returns false when stop is requested before an item is available
+    bool pop(T& item, const ext::StopToken& token)
+    {
+        std::unique_lock<std::mutex> lk {mtx_q_};
+        if (size_unsafe() == 0)
+        {
+            ++no_of_waiting_;
+            const bool not_empty = ext::wait(cv_q_not_empty_, lk, token, [this] { return size_unsafe() != 0; });
+            --no_of_waiting_;
+
+            if (!not_empty)
+                return false;
+        }
+        pop_most_urgent(item);
+
+        return true;
+    }
+
+    // returns false when the queue stays empty for timeout or stop is requested
+    template <typename Rep, typename Period>
+    bool pop_for(T& item, const ext::StopToken& token, const std::chrono::duration<Rep, Period>& timeout)
+    {
+        const TimePoint deadline = Clock::now() + timeout;
+
+        std::unique_lock<std::mutex> lk {mtx_q_};
+        if (size_unsafe() == 0)
+        {
+            ++no_of_waiting_;
+            const bool not_empty = ext::wait_until(cv_q_not_empty_, lk, token, deadline, [this] { return size_unsafe() != 0; });
+            --no_of_waiting_;
+
+            if (!not_empty)
+                return false;
+        }
+        pop_most_urgent(item);
+
+        return true;
+    }
+
+private:
+    struct Entry
+    {
+        T item;
+        TimePoint deadline;
+    };
+
+    struct LaterDeadline
+    {
+        bool operator()(const Entry& a, const Entry& b) const
+        {
+            return a.deadline > b.deadline;
+        }
+    };
+
+    static constexpr size_t no_of_levels = 3;
+
+    std::deque<Entry>& level(TaskPriority priority)
+    {
+        return levels_[static_cast<size_t>(priority)];
+    }
+
+    Clock::duration budget(TaskPriority priority) const
+    {
+        return aging_budgets_[static_cast<size_t>(priority)];
+    }
+
+    size_t size_unsafe() const
+    {
+        size_t size = deadline_heap_.size();
+        for (const auto& l : levels_)
+            size += l.size();
+        return size;
+    }
+
+    void push_item(T&& item, TaskPriority priority)
+    {
+        {
+            std::lock_guard<std::mutex> lk {mtx_q_};
+            level(priority).push_back(Entry {std::move(item), Clock::now() + budget(priority)});
+        }
+
+        cv_q_not_empty_.notify_one();
+    }
+
+    // queue must not be empty
+    void pop_most_urgent(T& item)
+    {
+        std::deque<Entry>* most_urgent_level = nullptr;
+        for (auto& l : levels_)
+        {
+            if (!l.empty() && (!most_urgent_level || l.front().deadline < most_urgent_level->front().deadline))
+                most_urgent_level = &l;
+        }
+
+        if (!deadline_heap_.empty() && (!most_urgent_level || deadline_heap_.front().deadline <= most_urgent_level->front().deadline))
+        {
+            std::pop_heap(deadline_heap_.begin(), deadline_heap_.end(), LaterDeadline {});
+            item = std::move(deadline_heap_.back().item);
+            deadline_heap_.pop_back();
+            return;
+        }
+
+        item = std::move(most_urgent_level->front().item);
+        most_urgent_level->pop_front();
+    }
+
+    const AgingBudgets aging_budgets_;
+    std::array<std::deque<Entry>, no_of_levels> levels_;
+    std::vector<Entry> deadline_heap_;
+    mutable std::mutex mtx_q_;
+    std::condition_variable cv_q_not_empty_;
+    size_t no_of_waiting_ {0};
+};
+
+#endif // PRIORITY_TASK_QUEUE_HPP
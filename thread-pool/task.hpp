@@ -0,0 +1,128 @@
+#ifndef TASK_HPP
+#define TASK_HPP
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ext
+{
+    // Move-only, type-erased void() callable (std::function is copyable and may allocate)
+    // Callables which fit in inline_size bytes and are nothrow movable are stored in place.
+    class Task
+    {
+    public:
+        static constexpr size_t inline_size = 64;
+
+        Task() = default;
+
+        Task(std::nullptr_t) noexcept
+        {
+        }
+
+        template <typename Callable, typename = std::enable_if_t<!std::is_same_v<std::decay_t<Callable>, Task>>>
+        Task(Callable&& callable)
+        {
+            using F = std::decay_t<Callable>;
+
+            if constexpr (is_stored_inline<F>)
+            {
+                new (&storage_) F(std::forward<Callable>(callable));
+                vtable_ = &inline_vtable<F>;
+            }
+            else
+            {
+                new (&storage_) F*(new F(std::forward<Callable>(callable)));
+                vtable_ = &heap_vtable<F>;
+            }
+        }
+
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        Task(Task&& other) noexcept
+        {
+            move_from(other);
+        }
+
+        Task& operator=(Task&& other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                move_from(other);
+            }
+            return *this;
+        }
+
+        Task& operator=(std::nullptr_t) noexcept
+        {
+            reset();
+            return *this;
+        }
+
+        ~Task()
+        {
+            reset();
+        }
+
+        explicit operator bool() const noexcept
+        {
+            return vtable_ != nullptr;
+        }
+
+        void operator()()
+        {
+            vtable_->invoke(&storage_);
+        }
+
+    private:
+        struct VTable
+        {
+            void (*invoke)(void* storage);
+            void (*move)(void* from, void* to) noexcept;
+            void (*destroy)(void* storage) noexcept;
+        };
+
+        template <typename F>
+        static constexpr bool is_stored_inline = sizeof(F) <= inline_size
+            && alignof(F) <= alignof(std::max_align_t)
+            && std::is_nothrow_move_constructible_v<F>;
+
+        template <typename F>
+        static inline const VTable inline_vtable {
+            [](void* storage) { (*static_cast<F*>(storage))(); },
+            [](void* from, void* to) noexcept {
+                new (to) F(std::move(*static_cast<F*>(from)));
+                static_cast<F*>(from)->~F();
+            },
+            [](void* storage) noexcept { static_cast<F*>(storage)->~F(); }};
+
+        template <typename F>
+        static inline const VTable heap_vtable {
+            [](void* storage) { (**static_cast<F**>(storage))(); },
+            [](void* from, void* to) noexcept { new (to) F*(*static_cast<F**>(from)); },
+            [](void* storage) noexcept { delete *static_cast<F**>(storage); }};
+
+        void move_from(Task& other) noexcept
+        {
+            if (other.vtable_)
+            {
+                other.vtable_->move(&other.storage_, &storage_);
+                vtable_ = std::exchange(other.vtable_, nullptr);
+            }
+        }
+
+        void reset() noexcept
+        {
+            if (vtable_)
+                std::exchange(vtable_, nullptr)->destroy(&storage_);
+        }
+
+        alignas(std::max_align_t) std::byte storage_[inline_size];
+        const VTable* vtable_ {};
+    };
+}
+
+#endif // TASK_HPP
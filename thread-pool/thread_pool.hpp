@@ -0,0 +1,551 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include "affinity.hpp"
+#include "bounded_queue.hpp"
+#include "future.hpp"
+#include "pool_stats.hpp"
+#include "priority_task_queue.hpp"
+#include "stop_token.hpp"
+#include "task.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Cancellation:
+//  - a callable which accepts ext::StopToken gets the token of the pool - long running tasks should poll it
+//    or register ext::StopCallback
+//  - shutdown_now() requests stop, discards queued tasks (their futures throw ext::OperationCancelled)
+//    and waits only for the running ones
+// Scheduling: submit(priority, f) and submit_before(deadline, f) - see PriorityTaskQueue
+// Elastic mode: ThreadPool(ElasticOptions {...}) keeps between min_threads and max_threads workers
+//  - a worker is spawned when queued tasks outnumber idle workers by queue_depth_threshold
+//    or no task has been taken from the non-empty queue for wait_time_threshold
+//  - a worker above min_threads retires after keep_alive without work
+//  - stats() exposes the resize decisions
+// Placement: ThreadPool(n, AffinityPolicy) or ElasticOptions::affinity pins the workers (see ext::CpuTopology)
+//  - worker k (in order of spawning) gets the k-th placement - the single queue is shared by all nodes
+// Instrumentation: define THREAD_POOL_STATS to record per-worker histograms of the wait time (submit -> start),
+// the service time and the queue depth, and the busy/idle time of the workers - task_stats() merges them
+//  - only 1 of THREAD_POOL_STATS_SAMPLE_PERIOD (64) submitted/taken tasks is timed - the others cost a countdown
+//  - without the macro nothing is recorded and no timestamp is taken
+class ThreadPool
+{
+public:
+    using Task = ext::Task;
+
+    // define THREAD_POOL_BOUNDED_QUEUE to switch to the lock-free ring buffer
+    // (submit() blocks when the queue is full - tasks which submit a lot of subtasks may deadlock the pool;
+    // FIFO only - submit(priority, f) and submit_before(deadline, f) are not available)
+#ifdef THREAD_POOL_BOUNDED_QUEUE
+    using TaskQueue = BoundedQueue<Task, 1024>;
+#else
+    using TaskQueue = PriorityTaskQueue<Task>;
+#endif
+
+    struct ElasticOptions
+    {
+        size_t min_threads;
+        size_t max_threads;
+        std::chrono::milliseconds keep_alive {1'000};
+        size_t queue_depth_threshold {1};
+        std::chrono::microseconds wait_time_threshold {1'000};
+        ext::AffinityPolicy affinity {ext::AffinityPolicy::none};
+    };
+
+    struct Stats
+    {
+        size_t no_of_threads;
+        size_t no_of_idle_threads;
+        size_t peak_no_of_threads;
+        size_t spawned_for_queue_depth;
+        size_t spawned_for_wait_time;
+        size_t retired;
+    };
+
+    // fixed number of workers (at least one - hardware_concurrency() may return 0)
+    ThreadPool(size_t num_of_threads = std::thread::hardware_concurrency())
+        : ThreadPool {fixed_size_options(num_of_threads, ext::AffinityPolicy::none)}
+    {
+    }
+
+    // fixed number of workers pinned according to the policy
+    ThreadPool(size_t num_of_threads, ext::AffinityPolicy affinity)
+        : ThreadPool {fixed_size_options(num_of_threads, affinity)}
+    {
+    }
+
+    explicit ThreadPool(const ElasticOptions& options)
+        : options_ {options.min_threads, std::max<size_t>({options.max_threads, options.min_threads, 1}), options.keep_alive,
+              std::max<size_t>(options.queue_depth_threshold, 1), options.wait_time_threshold, options.affinity}
+        , elastic_ {options_.min_threads < options_.max_threads}
+        , placements_ {ext::CpuTopology::system().place_workers(options_.affinity, options_.max_threads)}
+    {
+        std::lock_guard<std::mutex> lk {mtx_workers_};
+        while (workers_.size() < options_.min_threads)
+            spawn_worker();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // waits until all queued tasks are done
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lk {mtx_workers_};
+            closing_ = true;
+
+            if (!stop_source_.stop_requested())
+            {
+                const size_t no_of_workers = no_of_workers_; // workers leave while the sentinels are pushed
+                for (size_t i = 0; i < no_of_workers; ++i)
+                {
+                    push_sentinel();
+                }
+            }
+        }
+
+        join_workers();
+        drain_queued_tasks();
+    }
+
+    // requests stop of running tasks, cancels queued tasks and waits for the workers to finish
+    // tasks submitted after shutdown_now() are cancelled immediately
+    void shutdown_now()
+    {
+        stop_source_.request_stop();
+        join_workers();
+        drain_queued_tasks();
+    }
+
+    // current number of workers
+    size_t size() const
+    {
+        return no_of_workers_.load();
+    }
+
+    Stats stats() const
+    {
+        return Stats {no_of_workers_.load(), no_of_idle_.load(), peak_no_of_workers_.load(), spawned_for_queue_depth_.load(),
+            spawned_for_wait_time_.load(), retired_.load()};
+    }
+
+#ifdef THREAD_POOL_STATS
+    // busy_ratio has one entry per worker slot (slots of retired workers are reused by new ones)
+    ext::PoolStatsSnapshot task_stats() const
+    {
+        std::lock_guard<std::mutex> lk {mtx_workers_};
+        return ext::merge_stats(worker_stats_);
+    }
+#endif
+
+    template <typename Callable>
+    auto submit(Callable&& task)
+    {
+        // if (!task)
+        //     throw std::invalid_argument("Empty function is not allowed");
+
+        return submit_with(std::forward<Callable>(task), [this](Task&& pt) { queue_tasks_.push(std::move(pt)); });
+    }
+
+#ifndef THREAD_POOL_BOUNDED_QUEUE
+    template <typename Callable>
+    auto submit(TaskPriority priority, Callable&& task)
+    {
+        return submit_with(std::forward<Callable>(task), [this, priority](Task&& pt) { queue_tasks_.push(std::move(pt), priority); });
+    }
+
+    // task is started before the tasks with later deadlines (and before normal/low priority tasks
+    // pushed more than their aging budget after the deadline)
+    template <typename Callable>
+    auto submit_before(std::chrono::steady_clock::time_point deadline, Callable&& task)
+    {
+        return submit_with(std::forward<Callable>(task), [this, deadline](Task&& pt) { queue_tasks_.push_before(std::move(pt), deadline); });
+    }
+#endif
+
+    // enqueues all callables from a range under a single lock of the queue
+    template <typename Range>
+    auto submit_bulk(Range&& callables)
+    {
+        using Callable = decltype(*std::begin(callables));
+        using ResultT = std::invoke_result_t<std::decay_t<Callable>&>;
+
+        std::vector<Task> tasks;
+        std::vector<ext::Future<ResultT>> futures;
+
+        for (auto&& callable : callables)
+        {
+            auto [pt, f] = ext::make_packaged_task(make_cancellable(std::forward<Callable>(callable)));
+            tasks.push_back(std::move(pt));
+            futures.push_back(std::move(f));
+        }
+
+        add_queued(tasks.size());
+        queue_tasks_.push(std::make_move_iterator(tasks.begin()), std::make_move_iterator(tasks.end()));
+        after_push();
+
+        return futures;
+    }
+
+    // enqueues callable(0), callable(1), ..., callable(n-1) under a single lock of the queue
+    template <typename Callable>
+    auto submit_n(size_t n, Callable callable)
+    {
+        using ResultT = std::invoke_result_t<Callable&, size_t>;
+
+        std::vector<Task> tasks;
+        std::vector<ext::Future<ResultT>> futures;
+        tasks.reserve(n);
+        futures.reserve(n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            auto [pt, f] = ext::make_packaged_task(make_cancellable([callable, i]() mutable { return callable(i); }));
+            tasks.push_back(std::move(pt));
+            futures.push_back(std::move(f));
+        }
+
+        add_queued(tasks.size());
+        queue_tasks_.push(std::make_move_iterator(tasks.begin()), std::make_move_iterator(tasks.end()));
+        after_push();
+
+        return futures;
+    }
+
+private:
+    // min_threads == max_threads - clamping only max_threads to 1 would make an elastic 0..1 pool
+    static ElasticOptions fixed_size_options(size_t num_of_threads, ext::AffinityPolicy affinity)
+    {
+        const size_t no_of_threads = std::max<size_t>(num_of_threads, 1);
+        return ElasticOptions {no_of_threads, no_of_threads, std::chrono::milliseconds {1'000}, 1, std::chrono::microseconds {1'000}, affinity};
+    }
+
+    template <typename Callable, typename Push>
+    auto submit_with(Callable&& task, Push push)
+    {
+        auto [pt, f] = ext::make_packaged_task(make_cancellable(std::forward<Callable>(task)));
+
+        add_queued(1);
+        push(std::move(pt));
+        after_push();
+
+        return std::move(f);
+    }
+
+    void after_push()
+    {
+        // shutdown_now() may have drained the queue before our push
+        if (stop_source_.stop_requested())
+        {
+            drain_queued_tasks();
+            return;
+        }
+
+        if (elastic_)
+        {
+            const size_t no_of_idle = no_of_idle_.load();
+            const size_t no_of_queued = no_of_queued_.load();
+
+            if (no_of_queued >= no_of_idle + options_.queue_depth_threshold || no_of_workers_.load() == 0)
+                try_spawn_worker(spawned_for_queue_depth_);
+            else if (no_of_queued > no_of_idle && queue_stalled_for() >= options_.wait_time_threshold)
+                try_spawn_worker(spawned_for_wait_time_);
+        }
+    }
+
+    // the queue becoming non-empty restarts the stall clock - time when the queue was empty is not waiting
+    void add_queued(size_t no_of_tasks)
+    {
+        if (no_of_queued_.fetch_add(no_of_tasks) == 0)
+            stall_started_ = std::chrono::steady_clock::now().time_since_epoch().count();
+    }
+
+    // time since the last task was taken from the queue or since the queue became non-empty
+    // - lower bound of the wait time of the oldest queued task
+    std::chrono::steady_clock::duration queue_stalled_for() const
+    {
+        return std::chrono::steady_clock::now().time_since_epoch() - std::chrono::steady_clock::duration {stall_started_.load()};
+    }
+
+    void on_task_popped()
+    {
+        const auto stalled_for = queue_stalled_for();
+        stall_started_ = std::chrono::steady_clock::now().time_since_epoch().count();
+
+        // workers were busy for a long time and tasks are still waiting
+        if (stalled_for >= options_.wait_time_threshold && no_of_queued_.load() > no_of_idle_.load())
+            try_spawn_worker(spawned_for_wait_time_);
+    }
+
+    // the callable is not invoked if the pool has been stopped before the task started
+    template <typename Callable>
+    auto make_cancellable(Callable&& callable)
+    {
+#ifdef THREAD_POOL_STATS
+        const uint64_t submitted = submit_sampler_.next() ? ext::CycleClock::now() : 0; // 0 - not sampled
+        return [this, callable = std::forward<Callable>(callable), submitted]() mutable -> decltype(auto) {
+            if (stop_source_.stop_requested())
+                throw ext::OperationCancelled {};
+
+            // tasks left in the queue run on the destroying thread (see drain_queued_tasks()) - not recorded
+            if (submitted != 0)
+            {
+                if (ext::WorkerStats* worker_stats = this_worker_stats())
+                    worker_stats->wait_time.record(ext::CycleClock::now() - submitted);
+            }
+#else
+        return [this, callable = std::forward<Callable>(callable)]() mutable -> decltype(auto) {
+            if (stop_source_.stop_requested())
+                throw ext::OperationCancelled {};
+#endif
+
+            if constexpr (std::is_invocable_v<std::decay_t<Callable>&, ext::StopToken>)
+                return callable(stop_source_.get_token());
+            else
+                return callable();
+        };
+    }
+
+    // mtx_workers_ must be locked
+    void spawn_worker()
+    {
+        ++no_of_idle_; // counted as idle from now - a burst of submits does not spawn a worker per task
+        const auto& cpus = placements_[no_of_workers_ % placements_.size()].cpus;
+#ifdef THREAD_POOL_STATS
+        ext::WorkerStats* worker_stats = acquire_worker_stats();
+        workers_.emplace_back([this, stop_token = stop_source_.get_token(), cpus, worker_stats]
+            {
+                ext::pin_this_thread(cpus);
+                current_pool_ = this;
+                current_worker_stats_ = worker_stats;
+                run(stop_token);
+            });
+#else
+        workers_.emplace_back([this, stop_token = stop_source_.get_token(), cpus]
+            {
+                ext::pin_this_thread(cpus);
+                run(stop_token);
+            });
+#endif
+        ++no_of_workers_;
+        peak_no_of_workers_ = std::max(peak_no_of_workers_.load(), no_of_workers_.load());
+    }
+
+    void try_spawn_worker(std::atomic<size_t>& reason_counter)
+    {
+        std::lock_guard<std::mutex> lk {mtx_workers_};
+
+        if (closing_ || stop_source_.stop_requested() || no_of_workers_ >= options_.max_threads)
+            return;
+
+        reap_retired_workers();
+        spawn_worker();
+        ++reason_counter;
+    }
+
+    // mtx_workers_ must be locked - retired workers do not touch it anymore, so they can be joined here
+    void reap_retired_workers()
+    {
+        for (auto id : retired_ids_)
+        {
+            auto it = std::find_if(workers_.begin(), workers_.end(), [id](const std::thread& thd) { return thd.get_id() == id; });
+            it->join();
+            workers_.erase(it);
+        }
+        retired_ids_.clear();
+    }
+
+    // a worker with no work for keep_alive leaves if the pool stays above min_threads
+    bool try_retire()
+    {
+        std::lock_guard<std::mutex> lk {mtx_workers_};
+
+        if (no_of_workers_ <= options_.min_threads)
+            return false;
+
+        // leave first, then check the queue: a concurrent submit either sees fewer workers and spawns one
+        // or its task is seen here
+        --no_of_idle_;
+        --no_of_workers_;
+        if (no_of_queued_.load() > 0)
+        {
+            ++no_of_idle_;
+            ++no_of_workers_;
+            return false;
+        }
+
+        retired_ids_.push_back(std::this_thread::get_id());
+        ++retired_;
+#ifdef THREAD_POOL_STATS
+        free_worker_stats_.push_back(current_worker_stats_);
+#endif
+        return true;
+    }
+
+#ifdef THREAD_POOL_STATS
+    // nullptr if the calling thread is not a worker of this pool
+    ext::WorkerStats* this_worker_stats() const
+    {
+        return current_pool_ == this ? current_worker_stats_ : nullptr;
+    }
+
+    // mtx_workers_ must be locked
+    ext::WorkerStats* acquire_worker_stats()
+    {
+        if (free_worker_stats_.empty())
+        {
+            worker_stats_.push_back(std::make_unique<ext::WorkerStats>());
+            return worker_stats_.back().get();
+        }
+
+        ext::WorkerStats* worker_stats = free_worker_stats_.back();
+        free_worker_stats_.pop_back();
+        return worker_stats;
+    }
+#endif
+
+    void run(ext::StopToken stop_token)
+    {
+        Task task;
+#ifdef THREAD_POOL_STATS
+        ext::WorkerStats& worker_stats = *current_worker_stats_;
+        bool is_sampled = worker_stats.sampler.next();
+        uint64_t idle_started = is_sampled ? ext::CycleClock::now() : 0;
+#endif
+        while (true)
+        {
+            const bool popped = elastic_ ? queue_tasks_.pop_for(task, stop_token, options_.keep_alive) : queue_tasks_.pop(task, stop_token);
+
+            if (!popped)
+            {
+                if (stop_token.stop_requested())
+                    break;
+                if (try_retire())
+                    return;
+                continue;
+            }
+
+            if (!task) // end of work
+                break;
+
+            --no_of_idle_;
+#ifdef THREAD_POOL_STATS
+            const size_t no_of_queued = --no_of_queued_;
+#else
+            --no_of_queued_;
+#endif
+            if (elastic_)
+                on_task_popped();
+#ifdef THREAD_POOL_STATS
+            if (is_sampled)
+            {
+                const uint64_t task_started = ext::CycleClock::now();
+                worker_stats.add(worker_stats.idle_ticks, task_started - idle_started);
+                worker_stats.queue_depth.record(no_of_queued);
+                task();
+                const uint64_t task_ended = ext::CycleClock::now();
+                worker_stats.service_time.record(task_ended - task_started);
+                worker_stats.add(worker_stats.busy_ticks, task_ended - task_started);
+            }
+            else
+                task();
+
+            is_sampled = worker_stats.sampler.next();
+            if (is_sampled)
+                idle_started = ext::CycleClock::now();
+#else
+            task();
+#endif
+            task = nullptr;
+            ++no_of_idle_;
+        }
+
+        --no_of_idle_;
+        --no_of_workers_;
+    }
+
+    void join_workers()
+    {
+        std::vector<std::thread> workers;
+        {
+            std::lock_guard<std::mutex> lk {mtx_workers_};
+            closing_ = true;
+            workers = std::move(workers_);
+            workers_.clear();
+            retired_ids_.clear();
+        }
+
+        for (auto& t : workers)
+        {
+            if (t.joinable())
+                t.join();
+        }
+    }
+
+    // the sentinel which ends a worker is the least urgent entry - workers run every task queued before it
+    void push_sentinel()
+    {
+#ifdef THREAD_POOL_BOUNDED_QUEUE
+        queue_tasks_.push(Task {}); // FIFO
+#else
+        queue_tasks_.push_before(Task {}, TaskQueue::TimePoint::max());
+#endif
+    }
+
+    // runs the tasks left in the queue on the calling thread:
+    //  - after stop has been requested (shutdown_now(), submit after shutdown) they only store OperationCancelled
+    //  - in the destructor stop is not requested - leftovers (tasks submitted by running tasks after the sentinels)
+    //    run their callables, so the destructor still drains everything
+    // (try_pop() of BoundedQueue fails also while a concurrent push is not published yet - check empty())
+    void drain_queued_tasks()
+    {
+        Task task;
+        while (!queue_tasks_.empty())
+        {
+            if (queue_tasks_.try_pop(task) && task)
+            {
+                --no_of_queued_;
+                task();
+            }
+        }
+    }
+
+    const ElasticOptions options_;
+    const bool elastic_;
+    const std::vector<ext::WorkerPlacement> placements_;
+    ext::StopSource stop_source_ {};
+    TaskQueue queue_tasks_ {};
+
+    mutable std::mutex mtx_workers_;
+    std::vector<std::thread> workers_ {};
+    std::vector<std::thread::id> retired_ids_ {};
+    bool closing_ {false};
+
+    std::atomic<size_t> no_of_workers_ {0};
+    std::atomic<size_t> no_of_idle_ {0};
+    std::atomic<size_t> no_of_queued_ {0};
+    std::atomic<size_t> peak_no_of_workers_ {0};
+    std::atomic<size_t> spawned_for_queue_depth_ {0};
+    std::atomic<size_t> spawned_for_wait_time_ {0};
+    std::atomic<size_t> retired_ {0};
+    std::atomic<std::chrono::steady_clock::rep> stall_started_ {std::chrono::steady_clock::now().time_since_epoch().count()};
+
+#ifdef THREAD_POOL_STATS
+    std::vector<std::unique_ptr<ext::WorkerStats>> worker_stats_ {}; // guarded by mtx_workers_
+    std::vector<ext::WorkerStats*> free_worker_stats_ {};           // slots of retired workers
+    inline static thread_local ext::Sampler submit_sampler_ {};
+    inline static thread_local const ThreadPool* current_pool_ = nullptr;
+    inline static thread_local ext::WorkerStats* current_worker_stats_ = nullptr;
+#endif
+};
+
+#endif // THREAD_POOL_HPP
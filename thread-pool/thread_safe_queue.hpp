@@ -1,6 +1,9 @@
 #ifndef THREAD_SAFE_QUEUE_HPP
 #define THREAD_SAFE_QUEUE_HPP
 
+#include "stop_token.hpp"
+
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
 #include <queue>
@@ -11,6 +14,7 @@ class ThreadSafeQueue
     std::queue<T> q_;
     mutable std::mutex mtx_q_;
     std::condition_variable cv_q_not_empty_;
+    size_t no_of_waiting_ {0};
 public:
     ThreadSafeQueue() = default;
     ThreadSafeQueue(const ThreadSafeQueue&) = delete;
@@ -32,6 +36,16 @@ public:
         cv_q_not_empty_.notify_one();
     }
 
+    void push(T&& item)
+    {
+        {
+            std::lock_guard<std::mutex> lk{mtx_q_};
+            q_.push(std::move(item));
+        }
+
+        cv_q_not_empty_.notify_one();
+    }
+
     void push(std::initializer_list<T> items)
     {
         {
@@ -43,6 +57,27 @@ public:
         cv_q_not_empty_.notify_all();
     }   
 
+    // pushes range of items under one lock and wakes up only as many consumers as needed
+    template <typename InputIt>
+    void push(InputIt first, InputIt last)
+    {
+        size_t no_of_items = 0;
+        size_t no_of_waiting = 0;
+
+        {
+            std::lock_guard<std::mutex> lk{mtx_q_};
+            for (; first != last; ++first, ++no_of_items)
+                q_.push(*first);
+            no_of_waiting = no_of_waiting_;
+        }
+
+        if (no_of_items >= no_of_waiting)
+            cv_q_not_empty_.notify_all();
+        else
+            for (size_t i = 0; i < no_of_items; ++i)
+                cv_q_not_empty_.notify_one();
+    }
+
     // non-blocking operation - returns false when queue is empty 
     // or its mutex is locked by another thread
     bool try_pop(T& item)
@@ -51,7 +86,7 @@ public:
         
         if (lk.owns_lock() && !q_.empty())
         {
-            item = q_.front();
+            item = std::move(q_.front());
             q_.pop();
             
             return true;
@@ -64,10 +99,57 @@ public:
     void pop(T& item)
     {
         std::unique_lock<std::mutex> lk{mtx_q_};
-        cv_q_not_empty_.wait(lk, [this] { return !q_.empty();});
-        item = q_.front();
+        if (q_.empty())
+        {
+            ++no_of_waiting_;
+            cv_q_not_empty_.wait(lk, [this] { return !q_.empty();});
+            --no_of_waiting_;
+        }
+        item = std::move(q_.front());
         q_.pop();        
     } 
+
+    // blocking operation - waits if queue is empty
+    // returns false when stop is requested before an item is available
+    bool pop(T& item, const ext::StopToken& token)
+    {
+        std::unique_lock<std::mutex> lk{mtx_q_};
+        if (q_.empty())
+        {
+            ++no_of_waiting_;
+            const bool not_empty = ext::wait(cv_q_not_empty_, lk, token, [this] { return !q_.empty();});
+            --no_of_waiting_;
+
+            if (!not_empty)
+                return false;
+        }
+        item = std::move(q_.front());
+        q_.pop();
+
+        return true;
+    }
+
+    // returns false when the queue stays empty for timeout or stop is requested
+    template <typename Rep, typename Period>
+    bool pop_for(T& item, const ext::StopToken& token, const std::chrono::duration<Rep, Period>& timeout)
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+        std::unique_lock<std::mutex> lk{mtx_q_};
+        if (q_.empty())
+        {
+            ++no_of_waiting_;
+            const bool not_empty = ext::wait_until(cv_q_not_empty_, lk, token, deadline, [this] { return !q_.empty();});
+            --no_of_waiting_;
+
+            if (!not_empty)
+                return false;
+        }
+        item = std::move(q_.front());
+        q_.pop();
+
+        return true;
+    }
 };
 
 #endif // THREAD_SAFE_QUEUE_HPP
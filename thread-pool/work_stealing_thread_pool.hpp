@@ -0,0 +1,309 @@
+#ifndef WORK_STEALING_THREAD_POOL_HPP
+#define WORK_STEALING_THREAD_POOL_HPP
+
+#include "affinity.hpp"
+#include "future.hpp"
+#include "task.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// deque owned by a single worker:
+//  - owner pushes and pops at the front (LIFO - hot in cache)
+//  - thieves steal from the back (FIFO - oldest, usually biggest chunks of work)
+template <typename T>
+class WorkStealingQueue
+{
+    std::deque<T> q_;
+    mutable std::mutex mtx_q_;
+
+public:
+    WorkStealingQueue() = default;
+    WorkStealingQueue(const WorkStealingQueue&) = delete;
+    WorkStealingQueue& operator=(const WorkStealingQueue&) = delete;
+
+    bool empty() const
+    {
+        std::lock_guard<std::mutex> lk {mtx_q_};
+        return q_.empty();
+    }
+
+    void push(T item)
+    {
+        std::lock_guard<std::mutex> lk {mtx_q_};
+        q_.push_front(std::move(item));
+    }
+
+    template <typename Iterator>
+    void push(Iterator first, Iterator last)
+    {
+        std::lock_guard<std::mutex> lk {mtx_q_};
+        for (; first != last; ++first)
+            q_.push_front(std::move(*first));
+    }
+
+    bool try_pop(T& item)
+    {
+        std::lock_guard<std::mutex> lk {mtx_q_};
+        if (q_.empty())
+            return false;
+
+        item = std::move(q_.front());
+        q_.pop_front();
+        return true;
+    }
+
+    bool try_steal(T& item)
+    {
+        std::lock_guard<std::mutex> lk {mtx_q_};
+        if (q_.empty())
+            return false;
+
+        item = std::move(q_.back());
+        q_.pop_back();
+        return true;
+    }
+};
+
+// Thread pool with per-worker task queues:
+//  - tasks submitted from a worker thread go to its own queue (no contention with other workers)
+//  - tasks submitted from outside go to a shared injection queue
+//  - an idle worker takes work from: own queue -> injection queue -> other workers' queues
+// With an AffinityPolicy workers are pinned (see ext::CpuTopology) and every NUMA node has its own injection queue:
+//  - tasks submitted from outside go to the injection queue of the node the caller runs on
+//  - an idle worker looks at its own node first: own queue -> node's injection queue -> queues of node's workers,
+//    then the same on the other nodes
+class WorkStealingThreadPool
+{
+public:
+    using Task = ext::Task;
+
+    WorkStealingThreadPool(size_t num_of_threads = std::thread::hardware_concurrency(), ext::AffinityPolicy affinity = ext::AffinityPolicy::none)
+        : placements_ {ext::CpuTopology::system().place_workers(affinity, num_of_threads)}
+    {
+        size_t no_of_nodes = 1;
+        for (const auto& placement : placements_)
+            no_of_nodes = std::max<size_t>(no_of_nodes, placement.node + 1);
+
+        for (size_t node {0}; node < no_of_nodes; ++node)
+            injection_queues_.push_back(std::make_unique<WorkStealingQueue<Task>>());
+
+        for (size_t i {0}; i < num_of_threads; ++i)
+            local_queues_.push_back(std::make_unique<WorkStealingQueue<Task>>());
+
+        // victims of worker i: workers of the same node first (ring order), then the others
+        for (size_t i {0}; i < num_of_threads; ++i)
+        {
+            Victims victims;
+            for (bool same_node : {true, false})
+            {
+                for (size_t k = 1; k < num_of_threads; ++k)
+                {
+                    const size_t victim = (i + k) % num_of_threads;
+                    if ((placements_[victim].node == placements_[i].node) == same_node)
+                        victims.workers.push_back(victim);
+                }
+
+                if (same_node)
+                    victims.no_of_local = victims.workers.size();
+            }
+            victims_.push_back(std::move(victims));
+        }
+
+        for (size_t i {0}; i < num_of_threads; ++i)
+        {
+            thd_pool_.emplace_back([this, i]
+                {
+                    ext::pin_this_thread(placements_[i].cpus);
+                    run(i);
+                });
+        }
+    }
+
+    WorkStealingThreadPool(const WorkStealingThreadPool&) = delete;
+    WorkStealingThreadPool& operator=(const WorkStealingThreadPool&) = delete;
+
+    // waits until all submitted tasks are done (the same as ThreadPool)
+    ~WorkStealingThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lk {mtx_idle_};
+            done_ = true;
+        }
+        cv_idle_.notify_all();
+
+        for (auto& t : thd_pool_)
+        {
+            t.join();
+        }
+    }
+
+    size_t size() const
+    {
+        return thd_pool_.size();
+    }
+
+    template <typename Callable>
+    auto submit(Callable&& task)
+    {
+        auto [pt, f] = ext::make_packaged_task(std::forward<Callable>(task));
+
+        auto& queue = owner_ == this ? *local_queues_[index_] : *injection_queues_[local_node()];
+        push_pending(1, [&] { queue.push(std::move(pt)); });
+
+        return std::move(f);
+    }
+
+    // enqueues callable(0), callable(1), ..., callable(n-1) under a single lock of the queue
+    template <typename Callable>
+    auto submit_n(size_t n, Callable callable)
+    {
+        using ResultT = std::invoke_result_t<Callable&, size_t>;
+
+        std::vector<Task> tasks;
+        std::vector<ext::Future<ResultT>> futures;
+        tasks.reserve(n);
+        futures.reserve(n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            auto [pt, f] = ext::make_packaged_task([callable, i]() mutable { return callable(i); });
+            tasks.push_back(std::move(pt));
+            futures.push_back(std::move(f));
+        }
+
+        auto& queue = owner_ == this ? *local_queues_[index_] : *injection_queues_[local_node()];
+        push_pending(n, [&] { queue.push(std::make_move_iterator(tasks.begin()), std::make_move_iterator(tasks.end())); });
+
+        return futures;
+    }
+
+private:
+    // workers of the same node are first
+    struct Victims
+    {
+        std::vector<size_t> workers;
+        size_t no_of_local;
+    };
+
+    static inline thread_local WorkStealingThreadPool* owner_ {};
+    static inline thread_local size_t index_ {};
+
+    unsigned local_node() const
+    {
+        return injection_queues_.size() > 1 ? ext::CpuTopology::system().current_node() % injection_queues_.size() : 0;
+    }
+
+    // pending_tasks_ is incremented before the push - a worker may pop & decrement right after it,
+    // so the other order would wrap the counter for a while
+    template <typename Push>
+    void push_pending(size_t no_of_tasks, Push push)
+    {
+        pending_tasks_.fetch_add(no_of_tasks);
+        try
+        {
+            push();
+        }
+        catch (...)
+        {
+            pending_tasks_.fetch_sub(no_of_tasks);
+            throw;
+        }
+
+        wake_workers(no_of_tasks);
+    }
+
+    void wake_workers(size_t no_of_tasks)
+    {
+        // seq_cst pair with run(): either the sleeping worker sees pending_tasks_ > 0
+        // or we see it registered as idle and wake it up
+        if (no_of_tasks > 0 && idle_workers_.load() > 0)
+        {
+            { std::lock_guard<std::mutex> lk {mtx_idle_}; }
+            if (no_of_tasks == 1)
+                cv_idle_.notify_one();
+            else
+                cv_idle_.notify_all();
+        }
+    }
+
+    bool try_get_task(Task& task)
+    {
+        if (local_queues_[index_]->try_pop(task))
+            return true;
+
+        const size_t node = placements_[index_].node;
+        const auto& victims = victims_[index_];
+
+        if (injection_queues_[node]->try_steal(task))
+            return true;
+
+        for (size_t i = 0; i < victims.no_of_local; ++i)
+        {
+            if (local_queues_[victims.workers[i]]->try_steal(task))
+                return true;
+        }
+
+        for (size_t i = 1; i < injection_queues_.size(); ++i)
+        {
+            if (injection_queues_[(node + i) % injection_queues_.size()]->try_steal(task))
+                return true;
+        }
+
+        for (size_t i = victims.no_of_local; i < victims.workers.size(); ++i)
+        {
+            if (local_queues_[victims.workers[i]]->try_steal(task))
+                return true;
+        }
+
+        return false;
+    }
+
+    void run(size_t index)
+    {
+        owner_ = this;
+        index_ = index;
+
+        Task task;
+        while (true)
+        {
+            if (try_get_task(task))
+            {
+                pending_tasks_.fetch_sub(1);
+                task();
+                task = nullptr;
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lk {mtx_idle_};
+            idle_workers_.fetch_add(1);
+            cv_idle_.wait(lk, [this] { return done_ || pending_tasks_.load() > 0; });
+            idle_workers_.fetch_sub(1);
+
+            if (done_ && pending_tasks_.load() == 0)
+                return;
+        }
+    }
+
+    const std::vector<ext::WorkerPlacement> placements_;
+    std::vector<Victims> victims_ {};
+    std::vector<std::unique_ptr<WorkStealingQueue<Task>>> local_queues_ {};
+    std::vector<std::unique_ptr<WorkStealingQueue<Task>>> injection_queues_ {}; // one per NUMA node
+    std::vector<std::thread> thd_pool_ {};
+
+    std::atomic<size_t> pending_tasks_ {0};
+    std::atomic<size_t> idle_workers_ {0};
+    std::mutex mtx_idle_;
+    std::condition_variable cv_idle_;
+    bool done_ {false};
+};
+
+#endif // WORK_STEALING_THREAD_POOL_HPP